@@ -0,0 +1,332 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#define WORD_BITS 64
+#define BLOCK_WORDS 8        // Rank is stored for every 512-bit block
+#define SELECT_SAMPLE 8192   // Every 8192nd set bit remembers its block
+
+// A dense array of bits, stored in 64-bit words. Bit i lives in word i / 64
+// at position i % 64, so unlike a bit-field it can be indexed at run time.
+typedef struct {
+    uint64_t* words;
+    size_t bits;
+    size_t wordCount;
+    // Rank/select support, built by bitvecBuildRank()
+    uint64_t* blockRank;     // Number of set bits before each block
+    uint32_t* selectBlock;   // Block containing set bit number k * SELECT_SAMPLE
+    size_t ones;
+} BitVector;
+
+typedef void (*BitCallback)(size_t index, void* data);
+
+int bitvecInit(BitVector* bv, size_t bits) {
+    // Round up to whole 256-bit vectors so the AVX2 loops need no tail
+    bv->wordCount = (bits + 255) / 256 * 4;
+    bv->bits = bits;
+    bv->words = (uint64_t*)aligned_alloc(32, (bv->wordCount ? bv->wordCount : 4) * sizeof(uint64_t));
+    bv->blockRank = NULL;
+    bv->selectBlock = NULL;
+    bv->ones = 0;
+    if (bv->words == NULL) {
+        return -1;
+    }
+    memset(bv->words, 0, bv->wordCount * sizeof(uint64_t));
+    return 0;
+}
+
+void bitvecFree(BitVector* bv) {
+    free(bv->words);
+    free(bv->blockRank);
+    free(bv->selectBlock);
+    bv->words = NULL;
+    bv->blockRank = NULL;
+    bv->selectBlock = NULL;
+}
+
+static inline void bitvecSet(BitVector* bv, size_t i) {
+    bv->words[i / WORD_BITS] |= 1ULL << (i % WORD_BITS);
+}
+
+static inline void bitvecClear(BitVector* bv, size_t i) {
+    bv->words[i / WORD_BITS] &= ~(1ULL << (i % WORD_BITS));
+}
+
+static inline int bitvecTest(const BitVector* bv, size_t i) {
+    return (bv->words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+
+// Population count: the compiler emits POPCNT with -mpopcnt or -march=native
+size_t bitvecCount(const BitVector* bv) {
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    for (size_t i = 0; i < bv->wordCount; i += 4) {
+        c0 += __builtin_popcountll(bv->words[i]);
+        c1 += __builtin_popcountll(bv->words[i + 1]);
+        c2 += __builtin_popcountll(bv->words[i + 2]);
+        c3 += __builtin_popcountll(bv->words[i + 3]);
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+/* ---------- Bulk operations: dst = a OP b ---------- */
+
+typedef enum { BIT_AND, BIT_OR, BIT_XOR, BIT_ANDNOT } BitOp;
+
+// All three vectors must have the same size. dst may be a or b.
+void bitvecCombine(BitVector* dst, const BitVector* a, const BitVector* b, BitOp op) {
+    size_t n = dst->wordCount;
+    uint64_t* d = dst->words;
+    const uint64_t* x = a->words;
+    const uint64_t* y = b->words;
+#ifdef __AVX2__
+    for (size_t i = 0; i < n; i += 4) {
+        __m256i vx = _mm256_load_si256((const __m256i*)(x + i));
+        __m256i vy = _mm256_load_si256((const __m256i*)(y + i));
+        __m256i r;
+        switch (op) {
+            case BIT_AND: r = _mm256_and_si256(vx, vy); break;
+            case BIT_OR: r = _mm256_or_si256(vx, vy); break;
+            case BIT_XOR: r = _mm256_xor_si256(vx, vy); break;
+            default: r = _mm256_andnot_si256(vy, vx); break;  // x & ~y
+        }
+        _mm256_store_si256((__m256i*)(d + i), r);
+    }
+#else
+    // Word-parallel: 64 bits per operation
+    for (size_t i = 0; i < n; i++) {
+        switch (op) {
+            case BIT_AND: d[i] = x[i] & y[i]; break;
+            case BIT_OR: d[i] = x[i] | y[i]; break;
+            case BIT_XOR: d[i] = x[i] ^ y[i]; break;
+            default: d[i] = x[i] & ~y[i]; break;
+        }
+    }
+#endif
+}
+
+/* ---------- Rank and select ---------- */
+
+// Must be called again after the bits change. Extra space: 64 bits per 512
+// bits for rank, plus 32 bits per SELECT_SAMPLE set bits for select.
+int bitvecBuildRank(BitVector* bv) {
+    size_t blocks = bv->wordCount / BLOCK_WORDS + 1;
+    uint64_t* blockRank = (uint64_t*)realloc(bv->blockRank, (blocks + 1) * sizeof(uint64_t));
+    if (blockRank == NULL) {
+        return -1;
+    }
+    bv->blockRank = blockRank;
+
+    uint64_t total = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        blockRank[b] = total;
+        for (size_t w = b * BLOCK_WORDS; w < (b + 1) * BLOCK_WORDS && w < bv->wordCount; w++) {
+            total += __builtin_popcountll(bv->words[w]);
+        }
+    }
+    blockRank[blocks] = total;
+    bv->ones = total;
+
+    size_t samples = total / SELECT_SAMPLE + 1;
+    uint32_t* selectBlock = (uint32_t*)realloc(bv->selectBlock, samples * sizeof(uint32_t));
+    if (selectBlock == NULL) {
+        return -1;
+    }
+    bv->selectBlock = selectBlock;
+    size_t b = 0;
+    for (size_t s = 0; s < samples; s++) {
+        while (blockRank[b + 1] <= s * SELECT_SAMPLE) {
+            b++;
+        }
+        selectBlock[s] = (uint32_t)b;
+    }
+    return 0;
+}
+
+// Number of set bits in positions [0, i)
+size_t bitvecRank(const BitVector* bv, size_t i) {
+    size_t word = i / WORD_BITS;
+    size_t rank = bv->blockRank[word / BLOCK_WORDS];
+    for (size_t w = word & ~(size_t)(BLOCK_WORDS - 1); w < word; w++) {
+        rank += __builtin_popcountll(bv->words[w]);
+    }
+    if (i % WORD_BITS) {
+        rank += __builtin_popcountll(bv->words[word] << (WORD_BITS - i % WORD_BITS));
+    }
+    return rank;
+}
+
+// Position of the k-th set bit within one word (k counts from 0)
+static inline unsigned selectInWord(uint64_t word, unsigned k) {
+#ifdef __BMI2__
+    return __builtin_ctzll(_pdep_u64(1ULL << k, word));
+#else
+    while (k-- > 0) {
+        word &= word - 1;
+    }
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Position of the k-th set bit (k counts from 0), or bits if there is none
+size_t bitvecSelect(const BitVector* bv, size_t k) {
+    if (k >= bv->ones) {
+        return bv->bits;
+    }
+    // The samples narrow the binary search to a few blocks
+    size_t sample = k / SELECT_SAMPLE;
+    size_t low = bv->selectBlock[sample];
+    size_t high = (sample + 1) * SELECT_SAMPLE < bv->ones ? bv->selectBlock[sample + 1] + 1
+                                                          : bv->wordCount / BLOCK_WORDS + 1;
+    while (high - low > 1) {
+        size_t mid = (low + high) / 2;
+        if (bv->blockRank[mid] <= k) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    size_t remaining = k - bv->blockRank[low];
+    for (size_t w = low * BLOCK_WORDS;; w++) {
+        unsigned count = __builtin_popcountll(bv->words[w]);
+        if (remaining < count) {
+            return w * WORD_BITS + selectInWord(bv->words[w], (unsigned)remaining);
+        }
+        remaining -= count;
+    }
+}
+
+// Calls callback for every set bit in increasing order
+void bitvecForEachSet(const BitVector* bv, BitCallback callback, void* data) {
+    for (size_t w = 0; w < bv->wordCount; w++) {
+        uint64_t word = bv->words[w];
+        while (word != 0) {
+            callback(w * WORD_BITS + __builtin_ctzll(word), data);
+            word &= word - 1;  // Clear the lowest set bit
+        }
+    }
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void sumIndex(size_t index, void* data) {
+    *(size_t*)data += index;
+}
+
+static void report(const char* name, double bytes, double seconds) {
+    printf("%-22s %10.2f GB/s\n", name, bytes / seconds / 1e9);
+}
+
+int main(int argc, char* argv[]) {
+    size_t bits = argc > 1 ? strtoull(argv[1], NULL, 10) : (1ULL << 30);
+    if (bits < 128) {
+        bits = 128;  // Room for the small demo below and at least one random bit
+    }
+    size_t queries = 10000000;
+    uint64_t state = 88172645463325252ull;
+
+    BitVector a, b, c;
+    if (bitvecInit(&a, bits) != 0 || bitvecInit(&b, bits) != 0 || bitvecInit(&c, bits) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    double bytes = a.wordCount * sizeof(uint64_t);
+
+    bitvecSet(&a, 3);
+    bitvecSet(&a, 64);
+    bitvecSet(&a, 100);
+    bitvecBuildRank(&a);
+    printf("test(64)=%d rank(100)=%zu select(2)=%zu count=%zu\n", bitvecTest(&a, 64), bitvecRank(&a, 100),
+           bitvecSelect(&a, 2), bitvecCount(&a));
+    bitvecClear(&a, 3);
+    bitvecClear(&a, 64);
+    bitvecClear(&a, 100);
+
+    // Random set: every 8th bit on average is set in a, every 4th in b
+    double start = nowSeconds();
+    for (size_t i = 0; i < bits / 8; i++) {
+        bitvecSet(&a, nextRandom(&state) % bits);
+    }
+    double setTime = nowSeconds() - start;
+    for (size_t i = 0; i < bits / 4; i++) {
+        bitvecSet(&b, nextRandom(&state) % bits);
+    }
+
+    printf("\n%zu bits (%.0f MiB per vector)\n", bits, bytes / (1 << 20));
+    printf("%-22s %10.1f M ops/s\n", "random set", bits / 8 / setTime / 1e6);
+
+    size_t hits = 0;
+    start = nowSeconds();
+    for (size_t i = 0; i < queries; i++) {
+        hits += bitvecTest(&a, nextRandom(&state) % bits);
+    }
+    printf("%-22s %10.1f M ops/s\n", "random test", queries / (nowSeconds() - start) / 1e6);
+
+    start = nowSeconds();
+    size_t count = bitvecCount(&a);
+    report("popcount", bytes, nowSeconds() - start);
+
+    const char* names[4] = {"and", "or", "xor", "andnot"};
+    bitvecCombine(&c, &a, &b, BIT_OR);  // Warm up the output vector
+    for (int op = 0; op < 4; op++) {
+        start = nowSeconds();
+        bitvecCombine(&c, &a, &b, (BitOp)op);
+        report(names[op], 3 * bytes, nowSeconds() - start);  // Two inputs read, one output written
+    }
+
+    start = nowSeconds();
+    bitvecBuildRank(&a);
+    report("build rank/select", bytes, nowSeconds() - start);
+
+    size_t check = 0;
+    start = nowSeconds();
+    for (size_t i = 0; i < queries; i++) {
+        check += bitvecRank(&a, nextRandom(&state) % bits);
+    }
+    printf("%-22s %10.1f M ops/s\n", "rank", queries / (nowSeconds() - start) / 1e6);
+
+    int selectOk = 1;
+    start = nowSeconds();
+    for (size_t i = 0; a.ones > 0 && i < queries; i++) {
+        size_t k = nextRandom(&state) % a.ones;
+        size_t pos = bitvecSelect(&a, k);
+        if (i % 1024 == 0 && (bitvecRank(&a, pos) != k || !bitvecTest(&a, pos))) {
+            selectOk = 0;
+        }
+        check += pos;
+    }
+    printf("%-22s %10.1f M ops/s\n", "select", queries / (nowSeconds() - start) / 1e6);
+
+    size_t indexSum = 0;
+    start = nowSeconds();
+    bitvecForEachSet(&a, sumIndex, &indexSum);
+    report("iterate set bits", bytes, nowSeconds() - start);
+
+    printf("\n%zu bits set, rank(n)=%zu, select consistent with rank: %s\n", count, bitvecRank(&a, bits),
+           selectOk ? "yes" : "no");
+    printf("(checksum %zu)\n", hits + check + indexSum);
+
+    bitvecFree(&a);
+    bitvecFree(&b);
+    bitvecFree(&c);
+    return 0;
+}
\ No newline at end of file
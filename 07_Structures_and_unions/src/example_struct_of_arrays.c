@@ -0,0 +1,318 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define SOA_ALIGN 64  // Every field array starts on a cache line
+
+/* ---------- Generic column helpers ---------- */
+
+static void* soaAllocArray(size_t bytes) {
+    bytes = (bytes + SOA_ALIGN - 1) / SOA_ALIGN * SOA_ALIGN;  // aligned_alloc() needs a multiple
+    return aligned_alloc(SOA_ALIGN, bytes ? bytes : SOA_ALIGN);
+}
+
+double soaSumDouble(const double* values, size_t n) {
+    size_t i = 0;
+    double sum = 0;
+#ifdef __AVX2__
+    // Two accumulators hide the latency of the vector add
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+int64_t soaSumInt32(const int32_t* values, size_t n) {
+    size_t i = 0;
+    int64_t sum = 0;
+#ifdef __AVX2__
+    // Widen to 64 bits before adding so large columns cannot overflow
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(v));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+// Write the index of every element greater than threshold to out; returns the count
+size_t soaFilterGreaterDouble(const double* values, size_t n, double threshold, uint32_t* out) {
+    size_t i = 0, count = 0;
+#ifdef __AVX2__
+    __m256d limit = _mm256_set1_pd(threshold);
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + i), limit, _CMP_GT_OQ));
+        while (mask) {
+            out[count++] = (uint32_t)(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (values[i] > threshold) {
+            out[count++] = (uint32_t)i;
+        }
+    }
+    return count;
+}
+
+// Sum of values[i] for every i where keys[i] > threshold (two columns, one pass)
+int64_t soaSumInt32WhereGreater(const int32_t* values, const double* keys, size_t n, double threshold) {
+    size_t i = 0;
+    int64_t sum = 0;
+#ifdef __AVX2__
+    __m256d limit = _mm256_set1_pd(threshold);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i mask = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(keys + i), limit, _CMP_GT_OQ));
+        __m256i v = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(values + i)));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(v, mask));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        if (keys[i] > threshold) {
+            sum += values[i];
+        }
+    }
+    return sum;
+}
+
+/* ---------- Container generator ---------- */
+
+// FIELDS is an X-macro listing the members as X(type, name). DEFINE_SOA
+// generates the ordinary struct RECORD and a container NAME with one array per
+// member, plus NAME##Init, NAME##Reserve, NAME##Push, NAME##Get,
+// NAME##FromAos, NAME##ToAos and NAME##Free. Functions returning int give 0
+// on success, -1 on failure.
+#define SOA_RECORD_FIELD(type, name) type name;
+#define SOA_ARRAY_FIELD(type, name) type* name;
+#define SOA_NULL_FIELD(type, name) next.name = NULL;
+#define SOA_ALLOC_FIELD(type, name)                                  \
+    next.name = (type*)soaAllocArray(capacity * sizeof(type));       \
+    if (next.name == NULL) failed = 1;                               \
+    else if (v->size) memcpy(next.name, v->name, v->size * sizeof(type));
+#define SOA_FREE_NEXT_FIELD(type, name) free(next.name);
+#define SOA_FREE_FIELD(type, name) free(v->name);
+#define SOA_STORE_FIELD(type, name) v->name[v->size] = record->name;
+#define SOA_LOAD_FIELD(type, name) record.name = v->name[index];
+#define SOA_SCATTER_FIELD(type, name) \
+    for (size_t i = 0; i < count; i++) v->name[v->size + i] = records[i].name;
+#define SOA_GATHER_FIELD(type, name) \
+    for (size_t i = 0; i < v->size; i++) records[i].name = v->name[i];
+
+#define DEFINE_SOA(NAME, RECORD, FIELDS)                                  \
+    typedef struct {                                                      \
+        FIELDS(SOA_RECORD_FIELD)                                          \
+    } RECORD;                                                             \
+                                                                          \
+    typedef struct {                                                      \
+        FIELDS(SOA_ARRAY_FIELD)                                           \
+        size_t size;                                                      \
+        size_t capacity;                                                  \
+    } NAME;                                                               \
+                                                                          \
+    static inline void NAME##Init(NAME* v) {                              \
+        memset(v, 0, sizeof(*v));                                         \
+    }                                                                     \
+                                                                          \
+    static inline int NAME##Reserve(NAME* v, size_t capacity) {           \
+        if (capacity <= v->capacity) {                                    \
+            return 0;                                                     \
+        }                                                                 \
+        NAME next = *v;                                                   \
+        int failed = 0;                                                   \
+        FIELDS(SOA_NULL_FIELD)                                            \
+        FIELDS(SOA_ALLOC_FIELD)                                           \
+        if (failed) {                                                     \
+            FIELDS(SOA_FREE_NEXT_FIELD)                                   \
+            return -1;                                                    \
+        }                                                                 \
+        FIELDS(SOA_FREE_FIELD)                                            \
+        next.capacity = capacity;                                         \
+        *v = next;                                                        \
+        return 0;                                                         \
+    }                                                                     \
+                                                                          \
+    static inline int NAME##Push(NAME* v, const RECORD* record) {         \
+        if (v->size == v->capacity &&                                     \
+            NAME##Reserve(v, v->capacity ? v->capacity * 2 : 64) != 0) {  \
+            return -1;                                                    \
+        }                                                                 \
+        FIELDS(SOA_STORE_FIELD)                                           \
+        v->size++;                                                        \
+        return 0;                                                         \
+    }                                                                     \
+                                                                          \
+    static inline RECORD NAME##Get(const NAME* v, size_t index) {         \
+        RECORD record;                                                    \
+        FIELDS(SOA_LOAD_FIELD)                                            \
+        return record;                                                    \
+    }                                                                     \
+                                                                          \
+    /* Append an array of structs, one column at a time */                \
+    static inline int NAME##FromAos(NAME* v, const RECORD* records,       \
+                                    size_t count) {                       \
+        if (NAME##Reserve(v, v->size + count) != 0) {                     \
+            return -1;                                                    \
+        }                                                                 \
+        FIELDS(SOA_SCATTER_FIELD)                                         \
+        v->size += count;                                                 \
+        return 0;                                                         \
+    }                                                                     \
+                                                                          \
+    /* records must have room for v->size elements */                     \
+    static inline void NAME##ToAos(const NAME* v, RECORD* records) {      \
+        FIELDS(SOA_GATHER_FIELD)                                          \
+    }                                                                     \
+                                                                          \
+    static inline void NAME##Free(NAME* v) {                              \
+        FIELDS(SOA_FREE_FIELD)                                            \
+        NAME##Init(v);                                                    \
+    }
+
+#define TRADE_FIELDS(X)   \
+    X(int32_t, id)        \
+    X(double, price)      \
+    X(int32_t, quantity)  \
+    X(int64_t, timestamp) \
+    X(double, fee)
+
+DEFINE_SOA(TradeTable, Trade, TRADE_FIELDS)
+
+/* ---------- Array-of-structs versions of the same queries ---------- */
+
+double aosSumPrice(const Trade* trades, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += trades[i].price;
+    }
+    return sum;
+}
+
+size_t aosFilterPrice(const Trade* trades, size_t n, double threshold, uint32_t* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (trades[i].price > threshold) {
+            out[count++] = (uint32_t)i;
+        }
+    }
+    return count;
+}
+
+int64_t aosQuantityWherePrice(const Trade* trades, size_t n, double threshold) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (trades[i].price > threshold) {
+            sum += trades[i].quantity;
+        }
+    }
+    return sum;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    int repeats = 5;
+
+    TradeTable table;
+    TradeTableInit(&table);
+    Trade first = {1, 101.5, 300, 1700000000, 0.25};
+    TradeTablePush(&table, &first);
+    Trade copy = TradeTableGet(&table, 0);
+    printf("sizeof(Trade) = %zu bytes, trade %d: %d @ %.2f\n", sizeof(Trade), copy.id, copy.quantity, copy.price);
+    TradeTableFree(&table);
+
+    Trade* trades = (Trade*)malloc(n * sizeof(Trade));
+    uint32_t* hits = (uint32_t*)malloc(n * sizeof(uint32_t));
+    srand(1);
+    for (size_t i = 0; i < n; i++) {
+        trades[i].id = (int32_t)i;
+        trades[i].price = 50.0 + (rand() % 10000) / 100.0;
+        trades[i].quantity = 1 + rand() % 1000;
+        trades[i].timestamp = 1700000000 + (int64_t)i;
+        trades[i].fee = 0.1;
+    }
+
+    double start = nowSeconds();
+    TradeTableFromAos(&table, trades, n);
+    double convert = nowSeconds() - start;
+
+    double aosSum = 0, soaSum = 0;
+    size_t aosHits = 0, soaHits = 0;
+    int64_t aosQty = 0, soaQty = 0;
+    double t[6] = {0};
+
+    for (int r = 0; r < repeats; r++) {
+        start = nowSeconds();
+        aosSum = aosSumPrice(trades, n);
+        t[0] += nowSeconds() - start;
+        start = nowSeconds();
+        soaSum = soaSumDouble(table.price, table.size);
+        t[1] += nowSeconds() - start;
+
+        start = nowSeconds();
+        aosHits = aosFilterPrice(trades, n, 140.0, hits);
+        t[2] += nowSeconds() - start;
+        start = nowSeconds();
+        soaHits = soaFilterGreaterDouble(table.price, table.size, 140.0, hits);
+        t[3] += nowSeconds() - start;
+
+        start = nowSeconds();
+        aosQty = aosQuantityWherePrice(trades, n, 100.0);
+        t[4] += nowSeconds() - start;
+        start = nowSeconds();
+        soaQty = soaSumInt32WhereGreater(table.quantity, table.price, table.size, 100.0);
+        t[5] += nowSeconds() - start;
+    }
+
+    const char* names[3] = {"sum(price)", "filter price > 140", "sum(qty) where price > 100"};
+    printf("\n%zu records, million records/s\n", n);
+    printf("%-28s %10s %10s\n", "query", "AoS", "SoA");
+    for (int q = 0; q < 3; q++) {
+        printf("%-28s %10.0f %10.0f\n", names[q], n * repeats / t[2 * q] / 1e6, n * repeats / t[2 * q + 1] / 1e6);
+    }
+    printf("Results match: %s\n",
+           fabs(aosSum - soaSum) < 1e-6 * fabs(aosSum) && aosHits == soaHits && aosQty == soaQty ? "yes" : "no");
+
+    // Round trip back to structs
+    start = nowSeconds();
+    TradeTableToAos(&table, trades);
+    double back = nowSeconds() - start;
+    printf("AoS -> SoA: %.1f ms, SoA -> AoS: %.1f ms\n", convert * 1e3, back * 1e3);
+
+    TradeTableFree(&table);
+    free(trades);
+    free(hits);
+    return 0;
+}
\ No newline at end of file
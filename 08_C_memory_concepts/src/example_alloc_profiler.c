@@ -0,0 +1,444 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* ---------- Profiler (uses the real allocator) ---------- */
+
+#define MAX_CALLSITES 1024
+#define OTHER_SITE (MAX_CALLSITES - 1)  // Collects the call sites that did not fit
+#define SITE_TABLE_SIZE 4096            // Hash slots, a power of two; kept at most half full
+#define LIFETIME_BUCKETS 10  // <10ns, <100ns, ... , >=1s
+#define SAMPLE_EVERY 61      // Measure the lifetime of 1 in 61 allocations (odd, so
+                             // alternating call sites are both sampled)
+#define FLUSH_EVERY 4096     // Events buffered per thread before merging
+#define HEADER_MAGIC 0xA110CA7Eu
+
+typedef struct {
+    const char* file;
+    int line;
+    uint64_t allocs;
+    uint64_t allocBytes;
+    uint64_t frees;
+    uint64_t freeBytes;
+    uint64_t lifetimes[LIFETIME_BUCKETS];
+} CallSite;
+
+// Per-thread counters, merged into the global table in batches so the hot
+// path never takes a lock
+typedef struct {
+    uint64_t allocs[MAX_CALLSITES];
+    uint64_t allocBytes[MAX_CALLSITES];
+    uint64_t frees[MAX_CALLSITES];
+    uint64_t freeBytes[MAX_CALLSITES];
+    uint64_t lifetimes[MAX_CALLSITES][LIFETIME_BUCKETS];
+    int64_t liveDelta;  // Bytes allocated minus bytes freed since the last flush
+    int64_t peakDelta;  // Highest liveDelta since the last flush
+    int events;
+    int sampleCountdown;
+} ThreadBuffer;
+
+// Maps file:line to a slot in sites[]. Lookups run without the lock: index is
+// written last (release), so a reader that sees it also sees file and line.
+typedef struct {
+    const char* file;
+    int line;
+    _Atomic uint32_t index;  // 0 = empty, otherwise slot + 1
+} SiteSlot;
+
+// Stored in front of every block; 32 bytes keeps the user pointer 16-aligned
+typedef struct {
+    uint32_t magic;
+    uint32_t site;
+    uint64_t size;
+    uint64_t allocTime;  // 0 when this allocation was not sampled
+    uint64_t reserved;
+} BlockHeader;
+
+static CallSite sites[MAX_CALLSITES];
+static _Atomic int siteCount;
+static SiteSlot siteTable[SITE_TABLE_SIZE];
+static int siteTableUsed;          // Protected by profLock
+static int overflowSites;          // Distinct call sites merged into OTHER_SITE
+static _Atomic int siteTableFull;  // Set once new sites are no longer remembered
+static pthread_mutex_t profLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t bufferKey;
+static pthread_once_t profOnce = PTHREAD_ONCE_INIT;
+static _Thread_local ThreadBuffer* threadBuffer;
+// Protected by profLock. Threads add their share on every flush, so the peak
+// is exact for one thread and an estimate (each thread's own peak on top of
+// the live total at its flush) when several threads allocate at once.
+static int64_t liveBytes;
+static int64_t peakBytes;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void flushBuffer(ThreadBuffer* buf) {
+    int count = atomic_load(&siteCount);
+    pthread_mutex_lock(&profLock);
+    for (int i = 0; i < count; i++) {
+        sites[i].allocs += buf->allocs[i];
+        sites[i].allocBytes += buf->allocBytes[i];
+        sites[i].frees += buf->frees[i];
+        sites[i].freeBytes += buf->freeBytes[i];
+        for (int b = 0; b < LIFETIME_BUCKETS; b++) {
+            sites[i].lifetimes[b] += buf->lifetimes[i][b];
+        }
+    }
+    if (liveBytes + buf->peakDelta > peakBytes) {
+        peakBytes = liveBytes + buf->peakDelta;
+    }
+    liveBytes += buf->liveDelta;
+    pthread_mutex_unlock(&profLock);
+
+    int events = buf->events, countdown = buf->sampleCountdown;
+    memset(buf, 0, sizeof(*buf));
+    buf->events = events;
+    buf->sampleCountdown = countdown;
+}
+
+static void threadExit(void* arg) {
+    flushBuffer((ThreadBuffer*)arg);
+    free(arg);
+    threadBuffer = NULL;  // Destructors run in the exiting thread
+}
+
+static void printReport(void);
+
+static void profInit(void) {
+    pthread_key_create(&bufferKey, threadExit);
+    atexit(printReport);
+}
+
+static ThreadBuffer* getBuffer(void) {
+    if (threadBuffer == NULL) {
+        pthread_once(&profOnce, profInit);
+        threadBuffer = (ThreadBuffer*)calloc(1, sizeof(ThreadBuffer));
+        threadBuffer->sampleCountdown = SAMPLE_EVERY;
+        pthread_setspecific(bufferKey, threadBuffer);
+    }
+    return threadBuffer;
+}
+
+static uint32_t hashSite(const char* file, int line) {
+    uint64_t key = ((uint64_t)(uintptr_t)file ^ (uint64_t)line) * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(key >> 32) & (SITE_TABLE_SIZE - 1);
+}
+
+// Slow path of siteIndex(), taken once per call site
+static uint32_t addSite(const char* file, int line, uint32_t hash) {
+    pthread_mutex_lock(&profLock);
+    SiteSlot* slot;
+    for (uint32_t i = hash;; i = (i + 1) & (SITE_TABLE_SIZE - 1)) {
+        slot = &siteTable[i];
+        uint32_t index = atomic_load_explicit(&slot->index, memory_order_relaxed);
+        if (index == 0) {
+            break;
+        }
+        if (slot->line == line && slot->file == file) {  // Added by another thread
+            pthread_mutex_unlock(&profLock);
+            return index - 1;
+        }
+    }
+
+    uint32_t index = (uint32_t)atomic_load_explicit(&siteCount, memory_order_relaxed);
+    if (index >= OTHER_SITE) {
+        if (overflowSites++ == 0) {
+            sites[OTHER_SITE].file = "(other call sites)";
+            sites[OTHER_SITE].line = 0;
+            atomic_store_explicit(&siteCount, MAX_CALLSITES, memory_order_release);
+        }
+        index = OTHER_SITE;
+    } else {
+        sites[index].file = file;
+        sites[index].line = line;
+        atomic_store_explicit(&siteCount, (int)index + 1, memory_order_release);
+    }
+
+    if (++siteTableUsed >= SITE_TABLE_SIZE / 2) {
+        // Stop remembering new sites so probes always end at an empty slot;
+        // from here on unknown sites go to OTHER_SITE without the lock
+        atomic_store_explicit(&siteTableFull, 1, memory_order_relaxed);
+    }
+    slot->file = file;
+    slot->line = line;
+    atomic_store_explicit(&slot->index, index + 1, memory_order_release);
+    pthread_mutex_unlock(&profLock);
+    return index;
+}
+
+// Map file:line to a slot in sites[] with a lock-free hash lookup
+static uint32_t siteIndex(const char* file, int line) {
+    uint32_t hash = hashSite(file, line);
+    for (uint32_t i = hash;; i = (i + 1) & (SITE_TABLE_SIZE - 1)) {
+        SiteSlot* slot = &siteTable[i];
+        uint32_t index = atomic_load_explicit(&slot->index, memory_order_acquire);
+        if (index == 0) {
+            break;
+        }
+        if (slot->line == line && slot->file == file) {
+            return index - 1;
+        }
+    }
+    if (atomic_load_explicit(&siteTableFull, memory_order_relaxed)) {
+        return OTHER_SITE;
+    }
+    return addSite(file, line, hash);
+}
+
+static void countEvent(ThreadBuffer* buf) {
+    if (++buf->events >= FLUSH_EVERY) {
+        buf->events = 0;
+        flushBuffer(buf);
+    }
+}
+
+static void* recordAlloc(BlockHeader* header, size_t size, const char* file, int line) {
+    ThreadBuffer* buf = getBuffer();
+    uint32_t site = siteIndex(file, line);
+
+    header->magic = HEADER_MAGIC;
+    header->site = site;
+    header->size = size;
+    header->allocTime = 0;
+    if (--buf->sampleCountdown == 0) {
+        buf->sampleCountdown = SAMPLE_EVERY;
+        header->allocTime = nowNs();
+    }
+
+    buf->allocs[site]++;
+    buf->allocBytes[site] += size;
+    buf->liveDelta += (int64_t)size;
+    if (buf->liveDelta > buf->peakDelta) {
+        buf->peakDelta = buf->liveDelta;
+    }
+    countEvent(buf);
+    return header + 1;
+}
+
+static void recordFree(BlockHeader* header) {
+    ThreadBuffer* buf = getBuffer();
+    uint32_t site = header->site;
+
+    if (header->allocTime != 0) {
+        uint64_t lifetime = nowNs() - header->allocTime;
+        int bucket = 0;
+        for (uint64_t limit = 10; lifetime >= limit && bucket < LIFETIME_BUCKETS - 1; limit *= 10) {
+            bucket++;
+        }
+        // Scale the sample back up so the histogram estimates all frees
+        buf->lifetimes[site][bucket] += SAMPLE_EVERY;
+    }
+
+    buf->frees[site]++;
+    buf->freeBytes[site] += header->size;
+    buf->liveDelta -= (int64_t)header->size;
+    header->magic = 0;
+    countEvent(buf);
+}
+
+void* profMalloc(size_t size, const char* file, int line) {
+    BlockHeader* header = (BlockHeader*)malloc(sizeof(BlockHeader) + size);
+    return header ? recordAlloc(header, size, file, line) : NULL;
+}
+
+void* profCalloc(size_t count, size_t size, const char* file, int line) {
+    if (size != 0 && count > (SIZE_MAX - sizeof(BlockHeader)) / size) {
+        return NULL;
+    }
+    BlockHeader* header = (BlockHeader*)calloc(1, sizeof(BlockHeader) + count * size);
+    return header ? recordAlloc(header, count * size, file, line) : NULL;
+}
+
+void profFree(void* ptr, const char* file, int line) {
+    (void)file;
+    (void)line;
+    if (ptr == NULL) {
+        return;
+    }
+    BlockHeader* header = (BlockHeader*)ptr - 1;
+    if (header->magic != HEADER_MAGIC) {
+        fprintf(stderr, "profFree: invalid or double free at %s:%d\n", file, line);
+        abort();
+    }
+    recordFree(header);
+    free(header);
+}
+
+void* profRealloc(void* ptr, size_t size, const char* file, int line) {
+    if (ptr == NULL) {
+        return profMalloc(size, file, line);
+    }
+    BlockHeader* old = (BlockHeader*)ptr - 1;
+    if (old->magic != HEADER_MAGIC) {
+        fprintf(stderr, "profRealloc: invalid or freed pointer at %s:%d\n", file, line);
+        abort();
+    }
+    if (size > SIZE_MAX - sizeof(BlockHeader)) {
+        return NULL;
+    }
+    BlockHeader saved = *old;  // realloc() may free the old header
+    BlockHeader* header = (BlockHeader*)realloc(old, sizeof(BlockHeader) + size);
+    if (header == NULL) {
+        return NULL;  // The old block is unchanged and still counted
+    }
+    // Only now count the old block as freed and the new one as allocated
+    recordFree(&saved);
+    return recordAlloc(header, size, file, line);
+}
+
+static int compareBytes(const void* a, const void* b) {
+    const CallSite* x = (const CallSite*)a;
+    const CallSite* y = (const CallSite*)b;
+    return (x->allocBytes < y->allocBytes) - (x->allocBytes > y->allocBytes);
+}
+
+static void printReport(void) {
+    if (threadBuffer != NULL) {
+        flushBuffer(threadBuffer);
+    }
+
+    int count = atomic_load(&siteCount);
+    CallSite* sorted = (CallSite*)malloc(count * sizeof(CallSite));
+    pthread_mutex_lock(&profLock);
+    memcpy(sorted, sites, count * sizeof(CallSite));
+    int64_t live = liveBytes, peak = peakBytes;
+    int overflow = overflowSites, tableFull = atomic_load(&siteTableFull);
+    pthread_mutex_unlock(&profLock);
+    qsort(sorted, count, sizeof(CallSite), compareBytes);
+
+    static const char* bucketNames[LIFETIME_BUCKETS] = {
+        "<10ns", "<100ns", "<1us", "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+
+    fprintf(stderr, "\n===== Allocation profile (top call sites by bytes) =====\n");
+    fprintf(stderr, "%-28s %10s %12s %10s %12s  %s\n", "call site", "allocs", "bytes", "live", "live bytes",
+            "typical lifetime");
+    for (int i = 0; i < count && i < 20; i++) {
+        CallSite* s = &sorted[i];
+        const char* base = strrchr(s->file, '/');
+        char where[64];
+        if (s->line > 0) {
+            snprintf(where, sizeof(where), "%s:%d", base ? base + 1 : s->file, s->line);
+        } else {
+            snprintf(where, sizeof(where), "%s", s->file);
+        }
+
+        int mode = -1;
+        for (int b = 0; b < LIFETIME_BUCKETS; b++) {
+            if (s->lifetimes[b] > 0 && (mode < 0 || s->lifetimes[b] > s->lifetimes[mode])) {
+                mode = b;
+            }
+        }
+        fprintf(stderr, "%-28s %10llu %12llu %10llu %12llu  %s\n", where, (unsigned long long)s->allocs,
+                (unsigned long long)s->allocBytes, (unsigned long long)(s->allocs - s->frees),
+                (unsigned long long)(s->allocBytes - s->freeBytes), mode < 0 ? "-" : bucketNames[mode]);
+    }
+    fprintf(stderr, "Live at exit: %lld bytes, peak: %lld bytes\n", (long long)live, (long long)peak);
+    if (overflow > 0) {
+        fprintf(stderr, "Warning: %s%d call sites did not fit and are counted as \"%s\"; raise MAX_CALLSITES\n",
+                tableFull ? "at least " : "", overflow, sites[OTHER_SITE].file);
+    }
+    free(sorted);
+}
+
+/* ---------- Instrumented code ---------- */
+
+// Everything below this point is profiled. In a real program these lines go
+// in a header that is included after <stdlib.h> in every source file.
+#define malloc(size) profMalloc(size, __FILE__, __LINE__)
+#define calloc(count, size) profCalloc(count, size, __FILE__, __LINE__)
+#define realloc(ptr, size) profRealloc(ptr, size, __FILE__, __LINE__)
+#define free(ptr) profFree(ptr, __FILE__, __LINE__)
+
+struct Node {
+    int data;
+    struct Node* next;
+};
+
+void memory_leak() {
+    int* ptr = (int*)malloc(sizeof(int));
+    *ptr = 1;
+    // ptr is not freed before function returns
+}
+
+char* buildMessage(int id) {
+    char* msg = (char*)malloc(64);
+    snprintf(msg, 64, "request %d", id);
+    return msg;
+}
+
+void* requestWorker(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 100000; i++) {
+        char* msg = buildMessage(i);
+        int* scratch = (int*)calloc(16, sizeof(int));
+        scratch[0] = msg[0];
+        free(scratch);
+        free(msg);
+    }
+    return NULL;
+}
+
+int main() {
+    // A list that is built and kept alive until the end
+    struct Node* head = NULL;
+    for (int i = 0; i < 1000; i++) {
+        struct Node* node = (struct Node*)malloc(sizeof(struct Node));
+        node->data = i;
+        node->next = head;
+        head = node;
+    }
+
+    // A growing buffer, resized to the exact size every time
+    int* values = NULL;
+    for (int n = 1; n <= 1000; n++) {
+        values = (int*)realloc(values, n * sizeof(int));
+        values[n - 1] = n;
+    }
+
+    // Short-lived allocations from several threads
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, requestWorker, NULL);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        memory_leak();
+    }
+
+    // Overhead: the parenthesized name calls the real function, not the macro
+    int rounds = 2000000;
+    void* volatile sink;  // Keeps the compiler from removing the pairs
+    uint64_t start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        sink = (malloc)(32);
+        (free)(sink);
+    }
+    uint64_t raw = nowNs() - start;
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        sink = malloc(32);
+        free(sink);
+    }
+    uint64_t profiled = nowNs() - start;
+    printf("malloc+free: %.1f ns raw, %.1f ns profiled\n", (double)raw / rounds, (double)profiled / rounds);
+
+    while (head != NULL) {
+        struct Node* next = head->next;
+        free(head);
+        head = next;
+    }
+    free(values);
+    return 0;  // The report is printed by the atexit() handler
+}
\ No newline at end of file
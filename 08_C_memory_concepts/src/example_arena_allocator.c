@@ -0,0 +1,253 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+
+// One chunk of arena memory; blocks are chained so the arena can grow
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t capacity;
+    size_t used;
+    max_align_t data[];  // Flexible array member, maximally aligned
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* first;
+    ArenaBlock* current;
+    size_t blockSize;
+} Arena;
+
+// Position in the arena that can be returned to with arenaRestore()
+typedef struct {
+    ArenaBlock* block;
+    size_t used;
+} ArenaMarker;
+
+void arenaInit(Arena* arena, size_t blockSize) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->blockSize = blockSize ? blockSize : ARENA_DEFAULT_BLOCK;
+}
+
+static ArenaBlock* newBlock(size_t capacity) {
+    ArenaBlock* block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + capacity);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+// Offset of the first suitably aligned byte at or after block->used
+static size_t alignedOffset(const ArenaBlock* block, size_t align) {
+    uintptr_t start = (uintptr_t)block->data + block->used;
+    uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+    return aligned - (uintptr_t)block->data;
+}
+
+// align must be a power of two. Returns NULL if out of memory.
+void* arenaAllocAligned(Arena* arena, size_t size, size_t align) {
+    ArenaBlock* block = arena->current;
+
+    // No block could hold it, and size + align below must not wrap around
+    if (size > SIZE_MAX - sizeof(ArenaBlock) - align) {
+        return NULL;
+    }
+
+    // Fast path: bump the pointer inside the current block
+    if (block != NULL) {
+        size_t offset = alignedOffset(block, align);
+        if (offset <= block->capacity && size <= block->capacity - offset) {
+            block->used = offset + size;
+            return (unsigned char*)block->data + offset;
+        }
+    }
+
+    // Reuse the next block in the chain (left over from an earlier reset)
+    if (block != NULL && block->next != NULL && block->next->capacity >= size + align) {
+        block = block->next;
+        block->used = 0;
+    } else {
+        size_t capacity = arena->blockSize;
+        if (capacity < size + align) {
+            capacity = size + align;  // Oversized request gets its own block
+        }
+        ArenaBlock* fresh = newBlock(capacity);
+        if (fresh == NULL) {
+            return NULL;
+        }
+        if (block == NULL) {
+            fresh->next = arena->first;
+            arena->first = fresh;
+        } else {
+            fresh->next = block->next;
+            block->next = fresh;
+        }
+        block = fresh;
+    }
+
+    arena->current = block;
+    size_t offset = alignedOffset(block, align);
+    block->used = offset + size;
+    return (unsigned char*)block->data + offset;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    return arenaAllocAligned(arena, size, _Alignof(max_align_t));
+}
+
+void* arenaCalloc(Arena* arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void* ptr = arenaAlloc(arena, count * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+char* arenaStrdup(Arena* arena, const char* str) {
+    size_t len = strlen(str) + 1;
+    char* copy = (char*)arenaAllocAligned(arena, len, 1);
+    if (copy != NULL) {
+        memcpy(copy, str, len);
+    }
+    return copy;
+}
+
+ArenaMarker arenaSave(const Arena* arena) {
+    ArenaMarker marker = {arena->current, arena->current ? arena->current->used : 0};
+    return marker;
+}
+
+// Free everything allocated after the marker was taken
+void arenaRestore(Arena* arena, ArenaMarker marker) {
+    if (marker.block == NULL) {
+        arena->current = arena->first;
+        if (arena->current != NULL) {
+            arena->current->used = 0;
+        }
+        return;
+    }
+    arena->current = marker.block;
+    marker.block->used = marker.used;
+}
+
+// O(1): forget every allocation but keep the blocks for the next request
+void arenaReset(Arena* arena) {
+    arena->current = arena->first;
+    if (arena->current != NULL) {
+        arena->current->used = 0;
+    }
+}
+
+void arenaFree(Arena* arena) {
+    ArenaBlock* block = arena->first;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+/* ---------- Demo and benchmark ---------- */
+
+typedef struct Header {
+    char* name;
+    char* value;
+    struct Header* next;
+} Header;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Sizes of the objects one simulated request allocates
+static size_t objectSize(unsigned i) {
+    static const size_t sizes[] = {16, 24, 32, 48, 64, 96, 128, 256, 40, 512};
+    return sizes[(i * 7) % 10];
+}
+
+int main(int argc, char* argv[]) {
+    int requests = argc > 1 ? atoi(argv[1]) : 20000;
+    int objectsPerRequest = 1000;
+
+    Arena arena;
+    arenaInit(&arena, 0);
+
+    // Build a small linked list of request headers inside the arena
+    Header* headers = NULL;
+    const char* names[] = {"Host", "Accept", "User-Agent"};
+    const char* values[] = {"example.com", "*/*", "demo/1.0"};
+    for (int i = 0; i < 3; i++) {
+        Header* h = (Header*)arenaAlloc(&arena, sizeof(Header));
+        h->name = arenaStrdup(&arena, names[i]);
+        h->value = arenaStrdup(&arena, values[i]);
+        h->next = headers;
+        headers = h;
+    }
+    for (Header* h = headers; h != NULL; h = h->next) {
+        printf("%s: %s\n", h->name, h->value);
+    }
+
+    // Temporary scratch space released with a marker
+    ArenaMarker marker = arenaSave(&arena);
+    double* scratch = (double*)arenaAllocAligned(&arena, 1000 * sizeof(double), 64);
+    printf("Scratch buffer 64-byte aligned: %s\n", ((uintptr_t)scratch % 64 == 0) ? "yes" : "no");
+    arenaRestore(&arena, marker);
+
+    // All request memory is released at once
+    arenaReset(&arena);
+
+    // Benchmark: each request allocates many small objects and frees them all
+    void** objects = (void**)malloc(objectsPerRequest * sizeof(void*));
+    unsigned long checksum = 0;
+
+    double start = nowSeconds();
+    for (int r = 0; r < requests; r++) {
+        for (int i = 0; i < objectsPerRequest; i++) {
+            objects[i] = malloc(objectSize(i));
+            *(unsigned char*)objects[i] = (unsigned char)i;
+        }
+        for (int i = 0; i < objectsPerRequest; i++) {
+            checksum += *(unsigned char*)objects[i];
+            free(objects[i]);
+        }
+    }
+    double mallocTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (int r = 0; r < requests; r++) {
+        for (int i = 0; i < objectsPerRequest; i++) {
+            objects[i] = arenaAlloc(&arena, objectSize(i));
+            *(unsigned char*)objects[i] = (unsigned char)i;
+        }
+        for (int i = 0; i < objectsPerRequest; i++) {
+            checksum -= *(unsigned char*)objects[i];
+        }
+        arenaReset(&arena);
+    }
+    double arenaTime = nowSeconds() - start;
+
+    long total = (long)requests * objectsPerRequest;
+    printf("\n%d requests x %d objects\n", requests, objectsPerRequest);
+    printf("malloc/free: %.3f s (%.1f ns per object)\n", mallocTime, mallocTime * 1e9 / total);
+    printf("arena:       %.3f s (%.1f ns per object)\n", arenaTime, arenaTime * 1e9 / total);
+    printf("Speedup: %.1fx (checksum %s)\n", mallocTime / arenaTime, checksum == 0 ? "ok" : "mismatch");
+
+    free(objects);
+    arenaFree(&arena);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define CACHE_LINE 64
+#define MAX_SLOTS 256
+
+#define CACHE_ALIGNED _Alignas(CACHE_LINE)
+
+// Wraps TYPE so that every instance fills whole cache lines: an array of
+// NAME has no two elements on the same line
+#define DEFINE_PADDED(NAME, TYPE)                                           \
+    typedef struct {                                                        \
+        CACHE_ALIGNED TYPE value;                                           \
+    } NAME;                                                                 \
+    _Static_assert(sizeof(NAME) % CACHE_LINE == 0, #NAME " is not padded")
+
+DEFINE_PADDED(PaddedCounter, _Atomic long);
+
+// Allocation that starts on a cache line and is a whole number of lines long
+void* cacheAlignedAlloc(size_t size) {
+    size = (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    return aligned_alloc(CACHE_LINE, size ? size : CACHE_LINE);
+}
+
+/* ---------- Per-thread slots ---------- */
+
+static _Atomic int nextSlot;
+static _Thread_local int threadSlot = -1;
+
+// Small, dense id for the calling thread, assigned on first use
+int perThreadSlot(void) {
+    if (threadSlot < 0) {
+        threadSlot = atomic_fetch_add(&nextSlot, 1) % MAX_SLOTS;
+    }
+    return threadSlot;
+}
+
+// A counter split into one padded slot per thread. Each thread only writes
+// its own slot, so updates never move a cache line between cores; reading
+// the total sums all slots.
+typedef struct {
+    PaddedCounter slots[MAX_SLOTS];
+} PerThreadCounter;
+
+PerThreadCounter* perThreadCounterCreate(void) {
+    PerThreadCounter* counter = (PerThreadCounter*)cacheAlignedAlloc(sizeof(PerThreadCounter));
+    if (counter != NULL) {
+        for (int i = 0; i < MAX_SLOTS; i++) {
+            atomic_init(&counter->slots[i].value, 0);
+        }
+    }
+    return counter;
+}
+
+static inline void perThreadCounterAdd(PerThreadCounter* counter, long n) {
+    _Atomic long* slot = &counter->slots[perThreadSlot()].value;
+    // Slots shared by two threads (more than MAX_SLOTS threads) stay correct
+    atomic_fetch_add_explicit(slot, n, memory_order_relaxed);
+}
+
+long perThreadCounterRead(PerThreadCounter* counter) {
+    long total = 0;
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        total += atomic_load_explicit(&counter->slots[i].value, memory_order_relaxed);
+    }
+    return total;
+}
+
+/* ---------- Benchmark ---------- */
+
+typedef struct {
+    _Atomic long* counter;
+    long iterations;
+    int cpu;
+    int shared;  // 1: counter is shared by all threads, 0: the thread owns it
+} Worker;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* workerMain(void* arg) {
+    Worker* w = (Worker*)arg;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);  // One thread per core
+
+    if (w->shared) {
+        for (long i = 0; i < w->iterations; i++) {
+            atomic_fetch_add_explicit(w->counter, 1, memory_order_relaxed);
+        }
+    } else {
+        // Single writer: a plain load and store, no locked instruction
+        for (long i = 0; i < w->iterations; i++) {
+            long value = atomic_load_explicit(w->counter, memory_order_relaxed);
+            atomic_store_explicit(w->counter, value + 1, memory_order_relaxed);
+        }
+    }
+    return NULL;
+}
+
+// Run threads that each increment the counter at base + i * stride bytes
+// (stride 0: all threads share one counter). Returns million increments/s.
+static double runCounters(int threads, size_t stride, long iterations, int cpus) {
+    unsigned char* base = (unsigned char*)cacheAlignedAlloc(stride * threads + sizeof(long));
+    memset(base, 0, stride * threads + sizeof(long));
+    Worker* workers = (Worker*)malloc(threads * sizeof(Worker));
+    pthread_t* tids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+
+    for (int i = 0; i < threads; i++) {
+        workers[i].counter = (_Atomic long*)(base + i * stride);
+        workers[i].iterations = iterations;
+        workers[i].cpu = i % cpus;
+        workers[i].shared = stride == 0;
+    }
+    double start = nowSeconds();
+    for (int i = 0; i < threads; i++) pthread_create(&tids[i], NULL, workerMain, &workers[i]);
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    double elapsed = nowSeconds() - start;
+
+    free(base);
+    free(workers);
+    free(tids);
+    return (double)threads * iterations / elapsed / 1e6;
+}
+
+static void* slotWorker(void* arg) {
+    PerThreadCounter* counter = (PerThreadCounter*)arg;
+    for (int i = 0; i < 1000000; i++) {
+        perThreadCounterAdd(counter, 1);
+    }
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000000;
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int maxThreads = argc > 2 ? atoi(argv[2]) : (cpus < 2 ? 2 : cpus);
+
+    // The atomic counter example from chapter 14, with per-thread slots
+    PerThreadCounter* counter = perThreadCounterCreate();
+    pthread_t tids[4];
+    for (int i = 0; i < 4; i++) pthread_create(&tids[i], NULL, slotWorker, counter);
+    for (int i = 0; i < 4; i++) pthread_join(tids[i], NULL);
+    printf("Final counter value: %ld (sizeof(PaddedCounter) = %zu)\n", perThreadCounterRead(counter),
+           sizeof(PaddedCounter));
+    free(counter);
+
+    printf("\nMillion increments/s, %ld per thread, %d CPUs online\n", iterations, cpus);
+    printf("%8s %14s %14s %14s\n", "threads", "one atomic", "packed slots", "padded slots");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        printf("%8d %14.1f %14.1f %14.1f\n", threads, runCounters(threads, 0, iterations, cpus),
+               runCounters(threads, sizeof(long), iterations, cpus),
+               runCounters(threads, CACHE_LINE, iterations, cpus));
+    }
+
+    // False-sharing detector: move the counters further apart until the
+    // throughput stops improving. The jump shows the distance at which two
+    // cores stop interfering (64 bytes, or 128 where the adjacent-line
+    // prefetcher pulls in pairs of lines).
+    int threads = maxThreads < 2 ? 2 : maxThreads;
+    printf("\n%d threads, counter spacing sweep\n", threads);
+    printf("%8s %14s\n", "bytes", "M incr/s");
+    double previous = 0;
+    for (size_t stride = sizeof(long); stride <= 256; stride *= 2) {
+        double rate = runCounters(threads, stride, iterations, cpus);
+        printf("%8zu %14.1f%s\n", stride, rate, previous > 0 && rate > 1.5 * previous ? "  <- false sharing ends" : "");
+        previous = rate;
+    }
+    if (cpus < 2) {
+        printf("Only one CPU: the threads take turns, so false sharing cannot show up here.\n");
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#define HUGE_PAGE_SIZE (2UL << 20)
+
+// Flags for largeAlloc()
+#define LARGE_PREFAULT 1    // Touch every page now instead of on first use
+#define LARGE_NUMA_LOCAL 2  // Prefer memory on the NUMA node of the calling CPU
+#define LARGE_NO_HUGE 4     // Force normal 4 KiB pages (for comparison)
+
+typedef enum {
+    PAGES_HUGETLB,  // Reserved huge pages (MAP_HUGETLB)
+    PAGES_THP,      // Transparent huge pages requested with madvise()
+    PAGES_NORMAL
+} PageKind;
+
+typedef struct {
+    void* data;
+    size_t size;  // Mapped size, a multiple of HUGE_PAGE_SIZE
+    PageKind kind;
+} LargeBuffer;
+
+static const char* kindName(PageKind kind) {
+    return kind == PAGES_HUGETLB ? "hugetlb" : kind == PAGES_THP ? "THP" : "4K pages";
+}
+
+// Map size bytes at a 2 MiB aligned address by over-allocating and trimming
+static void* mapAligned(size_t size) {
+    size_t span = size + HUGE_PAGE_SIZE;
+    unsigned char* raw = (unsigned char*)mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+    uintptr_t start = ((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    size_t head = start - (uintptr_t)raw;
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    munmap((unsigned char*)start + size, span - head - size);
+    return (void*)start;
+}
+
+static void bindLocal(void* data, size_t size) {
+    unsigned cpu, node;
+    if (getcpu(&cpu, &node) != 0 || node >= 64) {
+        return;
+    }
+    unsigned long mask = 1UL << node;
+    // MPOL_PREFERRED falls back to other nodes instead of failing when the
+    // local node is full; glibc has no wrapper for mbind() without libnuma
+    syscall(SYS_mbind, data, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+}
+
+static void prefault(void* data, size_t size) {
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(data, size, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    // Older kernels: write one byte per page
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < size; offset += page) {
+        ((volatile unsigned char*)data)[offset] = 0;
+    }
+}
+
+// The active THP mode is the bracketed word, e.g. "always [madvise] never".
+// Returns 1 when madvise(MADV_HUGEPAGE) can give huge pages.
+static int thpEnabled(void) {
+    char line[128];
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (file == NULL) {
+        return 0;  // Kernel built without THP
+    }
+    int enabled = fgets(line, sizeof(line), file) != NULL && strstr(line, "[never]") == NULL;
+    fclose(file);
+    return enabled;
+}
+
+// Allocate a large buffer, trying reserved huge pages first, then
+// transparent huge pages, then normal pages. Returns 0 on success.
+int largeAlloc(LargeBuffer* buf, size_t size, int flags) {
+    size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    buf->size = size;
+    buf->data = NULL;
+
+    if (!(flags & LARGE_NO_HUGE)) {
+        // Fails unless the administrator reserved pages in /proc/sys/vm/nr_hugepages
+        void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) {
+            buf->data = data;
+            buf->kind = PAGES_HUGETLB;
+        }
+    }
+
+    if (buf->data == NULL) {
+        buf->data = mapAligned(size);
+        if (buf->data == NULL) {
+            return -1;
+        }
+        if (flags & LARGE_NO_HUGE) {
+            madvise(buf->data, size, MADV_NOHUGEPAGE);
+            buf->kind = PAGES_NORMAL;
+        } else {
+            // madvise() succeeds even when THP is "never", so it does not
+            // tell which pages we get; the sysfs setting does
+            int advised = madvise(buf->data, size, MADV_HUGEPAGE) == 0;
+            buf->kind = advised && thpEnabled() ? PAGES_THP : PAGES_NORMAL;
+        }
+    }
+
+    // The policy must be set before the pages are first touched
+    if (flags & LARGE_NUMA_LOCAL) {
+        bindLocal(buf->data, size);
+    }
+    if (flags & LARGE_PREFAULT) {
+        prefault(buf->data, size);
+    }
+    return 0;
+}
+
+void largeFree(LargeBuffer* buf) {
+    if (buf->data != NULL) {
+        munmap(buf->data, buf->size);
+        buf->data = NULL;
+    }
+}
+
+/* ---------- Random access benchmark ---------- */
+
+// Size of the process's anonymous memory backed by transparent huge pages
+static long anonHugeKiB(void) {
+    long kib = 0;
+    char line[256];
+    FILE* file = fopen("/proc/self/smaps_rollup", "r");
+    if (file == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "AnonHugePages: %ld", &kib) == 1) {
+            break;
+        }
+    }
+    fclose(file);
+    return kib;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Link the 64-byte lines into one cycle in shuffled order, so each load
+// depends on the previous one and the hardware cannot prefetch
+static void buildChain(uint64_t* data, size_t lines, const uint32_t* order) {
+    const size_t stride = 64 / sizeof(uint64_t);
+    for (size_t i = 0; i < lines; i++) {
+        data[order[i] * stride] = order[(i + 1) % lines] * stride;
+    }
+}
+
+static double chaseNs(const uint64_t* data, size_t steps, uint64_t* sink) {
+    uint64_t index = 0;
+    double start = nowSeconds();
+    for (size_t i = 0; i < steps; i++) {
+        index = data[index];
+    }
+    double elapsed = nowSeconds() - start;
+    *sink += index;
+    return elapsed * 1e9 / steps;
+}
+
+int main(int argc, char* argv[]) {
+    size_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 1024;
+    size_t size = mib << 20;
+    size_t lines = size / 64;
+    size_t steps = 20000000;
+    uint64_t sink = 0;
+
+    uint32_t* order = (uint32_t*)malloc(lines * sizeof(uint32_t));
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < lines; i++) {
+        order[i] = (uint32_t)i;
+    }
+    for (size_t i = lines - 1; i > 0; i--) {
+        size_t j = nextRandom(&state) % (i + 1);
+        uint32_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    printf("Pointer chase over %zu MiB (%zu steps)\n", mib, steps);
+    printf("%-10s %12s %14s %16s\n", "pages", "setup ms", "ns / access", "huge page MiB");
+
+    int modes[2] = {LARGE_NO_HUGE, 0};
+    for (int m = 0; m < 2; m++) {
+        LargeBuffer buf;
+        long hugeBefore = anonHugeKiB();
+        double start = nowSeconds();
+        if (largeAlloc(&buf, size, modes[m] | LARGE_PREFAULT | LARGE_NUMA_LOCAL) != 0) {
+            perror("largeAlloc");
+            return 1;
+        }
+        double setup = nowSeconds() - start;
+        long hugeKiB = anonHugeKiB() - hugeBefore;
+
+        buildChain((uint64_t*)buf.data, lines, order);
+        double ns = chaseNs((const uint64_t*)buf.data, steps, &sink);
+        printf("%-10s %12.1f %14.1f %16ld\n", kindName(buf.kind), setup * 1e3, ns,
+               buf.kind == PAGES_HUGETLB ? (long)(buf.size >> 20) : hugeKiB / 1024);
+        largeFree(&buf);
+    }
+
+    free(order);
+    printf("(checksum %llu)\n", (unsigned long long)sink);
+    return 0;
+}
\ No newline at end of file
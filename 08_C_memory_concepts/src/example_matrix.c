@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define MATRIX_ALIGN 64  // Cache line size; also enough for AVX-512 loads
+#define BLOCK 64         // Tile size for the cache-blocked kernels
+
+// A matrix is one contiguous allocation. stride is the distance in elements
+// between the starts of two rows; it can be larger than cols (padding, or a
+// view into a bigger matrix).
+typedef struct {
+    double* data;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+} Matrix;
+
+#define MAT(m, i, j) ((m)->data[(i) * (m)->stride + (j)])
+
+int matrixInit(Matrix* m, size_t rows, size_t cols) {
+    size_t perLine = MATRIX_ALIGN / sizeof(double);
+    m->rows = rows;
+    m->cols = cols;
+    m->stride = (cols + perLine - 1) / perLine * perLine;  // Every row starts on a cache line
+    size_t bytes = rows * m->stride * sizeof(double);
+    m->data = (double*)aligned_alloc(MATRIX_ALIGN, bytes ? bytes : MATRIX_ALIGN);
+    if (m->data == NULL) {
+        return -1;
+    }
+    memset(m->data, 0, bytes);
+    return 0;
+}
+
+void matrixFree(Matrix* m) {
+    free(m->data);
+    m->data = NULL;
+}
+
+// A view shares the parent's memory; it must not be passed to matrixFree()
+Matrix matrixView(const Matrix* m, size_t row, size_t col, size_t rows, size_t cols) {
+    Matrix view = {m->data + row * m->stride + col, rows, cols, m->stride};
+    return view;
+}
+
+// Transpose tile by tile so both the reads and the writes stay in cache
+void matrixTranspose(Matrix* dst, const Matrix* src) {
+    for (size_t ii = 0; ii < src->rows; ii += BLOCK) {
+        size_t iEnd = ii + BLOCK < src->rows ? ii + BLOCK : src->rows;
+        for (size_t jj = 0; jj < src->cols; jj += BLOCK) {
+            size_t jEnd = jj + BLOCK < src->cols ? jj + BLOCK : src->cols;
+            for (size_t i = ii; i < iEnd; i++) {
+                for (size_t j = jj; j < jEnd; j++) {
+                    MAT(dst, j, i) = MAT(src, i, j);
+                }
+            }
+        }
+    }
+}
+
+// c = a * b with i-k-j loop order inside BLOCK x BLOCK tiles. The innermost
+// loop runs over contiguous rows of b and c, which the compiler vectorizes.
+void matrixMultiply(Matrix* c, const Matrix* a, const Matrix* b) {
+    size_t n = a->rows, m = b->cols, p = a->cols;
+
+    for (size_t i = 0; i < n; i++) {
+        memset(&MAT(c, i, 0), 0, m * sizeof(double));
+    }
+
+    for (size_t ii = 0; ii < n; ii += BLOCK) {
+        size_t iEnd = ii + BLOCK < n ? ii + BLOCK : n;
+        for (size_t kk = 0; kk < p; kk += BLOCK) {
+            size_t kEnd = kk + BLOCK < p ? kk + BLOCK : p;
+            for (size_t jj = 0; jj < m; jj += BLOCK) {
+                size_t jEnd = jj + BLOCK < m ? jj + BLOCK : m;
+                for (size_t i = ii; i < iEnd; i++) {
+                    double* restrict cRow = &MAT(c, i, 0);
+                    for (size_t k = kk; k < kEnd; k++) {
+                        const double aik = MAT(a, i, k);
+                        const double* restrict bRow = &MAT(b, k, 0);
+                        for (size_t j = jj; j < jEnd; j++) {
+                            cRow[j] += aik * bRow[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* ---------- Row-pointer baseline (as in example_dynamic_arrays.c) ---------- */
+
+double** allocRows(int rows, int cols) {
+    double** array = (double**)malloc(rows * sizeof(double*));
+    for (int i = 0; i < rows; i++) {
+        array[i] = (double*)calloc(cols, sizeof(double));
+    }
+    return array;
+}
+
+void freeRows(double** array, int rows) {
+    for (int i = 0; i < rows; i++) {
+        free(array[i]);
+    }
+    free(array);
+}
+
+void naiveMultiply(double** c, double** a, double** b, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0;
+            for (int k = 0; k < n; k++) {
+                sum += a[i][k] * b[k][j];
+            }
+            c[i][j] = sum;
+        }
+    }
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1024;
+    double flops = 2.0 * n * n * n;
+
+    // Small demo: transpose of a 2 x 3 matrix and a view of its right column
+    Matrix small, smallT;
+    matrixInit(&small, 2, 3);
+    matrixInit(&smallT, 3, 2);
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            MAT(&small, i, j) = i * 3 + j;
+        }
+    }
+    matrixTranspose(&smallT, &small);
+    for (size_t i = 0; i < 3; i++) {
+        printf("%4.0f %4.0f\n", MAT(&smallT, i, 0), MAT(&smallT, i, 1));
+    }
+    Matrix column = matrixView(&small, 0, 2, 2, 1);
+    printf("View of column 2: %.0f %.0f (stride %zu)\n\n", MAT(&column, 0, 0), MAT(&column, 1, 0), column.stride);
+    matrixFree(&small);
+    matrixFree(&smallT);
+
+    // Benchmark: n x n double matrix multiply
+    Matrix a, b, c;
+    matrixInit(&a, n, n);
+    matrixInit(&b, n, n);
+    matrixInit(&c, n, n);
+    double** ra = allocRows(n, n);
+    double** rb = allocRows(n, n);
+    double** rc = allocRows(n, n);
+
+    srand(1);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            ra[i][j] = MAT(&a, i, j) = (double)rand() / RAND_MAX;
+            rb[i][j] = MAT(&b, i, j) = (double)rand() / RAND_MAX;
+        }
+    }
+
+    double start = nowSeconds();
+    naiveMultiply(rc, ra, rb, n);
+    double naive = nowSeconds() - start;
+
+    start = nowSeconds();
+    matrixMultiply(&c, &a, &b);
+    double blocked = nowSeconds() - start;
+
+    double maxDiff = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            maxDiff = fmax(maxDiff, fabs(rc[i][j] - MAT(&c, i, j)));
+        }
+    }
+
+    Matrix t;
+    matrixInit(&t, n, n);
+    start = nowSeconds();
+    matrixTranspose(&t, &a);
+    double transpose = nowSeconds() - start;
+
+    printf("%d x %d matrix multiply\n", n, n);
+    printf("Row pointers, naive:   %8.3f s %8.2f GFLOP/s\n", naive, flops / naive / 1e9);
+    printf("Contiguous, blocked:   %8.3f s %8.2f GFLOP/s\n", blocked, flops / blocked / 1e9);
+    printf("Max difference: %g\n", maxDiff);
+    printf("Blocked transpose: %.2f GB/s\n", 2.0 * n * n * sizeof(double) / transpose / 1e9);
+
+    matrixFree(&a);
+    matrixFree(&b);
+    matrixFree(&c);
+    matrixFree(&t);
+    freeRows(ra, n);
+    freeRows(rb, n);
+    freeRows(rc, n);
+    return 0;
+}
\ No newline at end of file
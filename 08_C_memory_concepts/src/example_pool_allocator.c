@@ -0,0 +1,341 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define SLAB_PAGES 16    // Each slab is 16 pages (64 KiB with 4 KiB pages)
+#define CACHE_BATCH 32   // Objects moved between a thread cache and the pool at once
+
+// A free slot stores the link to the next free slot inside itself
+typedef struct PoolSlot {
+    struct PoolSlot* next;
+} PoolSlot;
+
+// Slabs are page-aligned mmap() regions; the header sits in the first bytes
+typedef struct Slab {
+    struct Slab* next;
+} Slab;
+
+typedef struct {
+    size_t objectSize;
+    size_t slabSize;
+    PoolSlot* freeList;
+    Slab* slabs;
+    unsigned char* bump;     // Next never-used slot in the newest slab
+    unsigned char* bumpEnd;
+    size_t slabCount;
+    pthread_mutex_t lock;    // Only taken by the thread-cache functions
+} Pool;
+
+// Per-thread cache of free slots; avoids the pool lock on most calls
+typedef struct {
+    Pool* pool;
+    PoolSlot* head;
+    int count;
+} PoolCache;
+
+// Slots are aligned like malloc() memory, so any object type fits in them
+int poolInit(Pool* pool, size_t objectSize) {
+    size_t align = _Alignof(max_align_t);
+    if (objectSize < sizeof(PoolSlot)) {
+        objectSize = sizeof(PoolSlot);
+    }
+    pool->objectSize = (objectSize + align - 1) & ~(align - 1);
+    pool->slabSize = (size_t)sysconf(_SC_PAGESIZE) * SLAB_PAGES;
+    if (pool->objectSize > pool->slabSize - sizeof(Slab)) {
+        return -1;  // Large objects belong in malloc()
+    }
+    pool->freeList = NULL;
+    pool->slabs = NULL;
+    pool->bump = pool->bumpEnd = NULL;
+    pool->slabCount = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    return 0;
+}
+
+void poolDestroy(Pool* pool) {
+    Slab* slab = pool->slabs;
+    while (slab != NULL) {
+        Slab* next = slab->next;
+        munmap(slab, pool->slabSize);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    pool->bump = pool->bumpEnd = NULL;
+    pthread_mutex_destroy(&pool->lock);
+}
+
+static int addSlab(Pool* pool) {
+    void* mem = mmap(NULL, pool->slabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return -1;
+    }
+    Slab* slab = (Slab*)mem;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slabCount++;
+
+    // Slots are carved lazily, so untouched pages of the slab stay unmapped
+    size_t header = (sizeof(Slab) + pool->objectSize - 1) / pool->objectSize * pool->objectSize;
+    pool->bump = (unsigned char*)mem + header;
+    pool->bumpEnd = (unsigned char*)mem + pool->slabSize - pool->objectSize + 1;
+    return 0;
+}
+
+// Single-threaded allocation: pop the free list, else carve a new slot
+void* poolAlloc(Pool* pool) {
+    PoolSlot* slot = pool->freeList;
+    if (slot != NULL) {
+        pool->freeList = slot->next;
+        return slot;
+    }
+    if (pool->bump >= pool->bumpEnd && addSlab(pool) != 0) {
+        return NULL;
+    }
+    void* ptr = pool->bump;
+    pool->bump += pool->objectSize;
+    return ptr;
+}
+
+void poolFree(Pool* pool, void* ptr) {
+    PoolSlot* slot = (PoolSlot*)ptr;
+    slot->next = pool->freeList;
+    pool->freeList = slot;
+}
+
+void poolCacheInit(PoolCache* cache, Pool* pool) {
+    cache->pool = pool;
+    cache->head = NULL;
+    cache->count = 0;
+}
+
+void* poolCacheAlloc(PoolCache* cache) {
+    if (cache->head == NULL) {
+        // Refill a whole batch under one lock acquisition
+        pthread_mutex_lock(&cache->pool->lock);
+        for (int i = 0; i < CACHE_BATCH; i++) {
+            PoolSlot* slot = (PoolSlot*)poolAlloc(cache->pool);
+            if (slot == NULL) {
+                break;
+            }
+            slot->next = cache->head;
+            cache->head = slot;
+            cache->count++;
+        }
+        pthread_mutex_unlock(&cache->pool->lock);
+        if (cache->head == NULL) {
+            return NULL;
+        }
+    }
+    PoolSlot* slot = cache->head;
+    cache->head = slot->next;
+    cache->count--;
+    return slot;
+}
+
+static void returnSlots(PoolCache* cache, int count) {
+    pthread_mutex_lock(&cache->pool->lock);
+    while (count-- > 0 && cache->head != NULL) {
+        PoolSlot* slot = cache->head;
+        cache->head = slot->next;
+        cache->count--;
+        poolFree(cache->pool, slot);
+    }
+    pthread_mutex_unlock(&cache->pool->lock);
+}
+
+// Objects may be freed by a different thread than the one that allocated them
+void poolCacheFree(PoolCache* cache, void* ptr) {
+    PoolSlot* slot = (PoolSlot*)ptr;
+    slot->next = cache->head;
+    cache->head = slot;
+    if (++cache->count > 2 * CACHE_BATCH) {
+        returnSlots(cache, CACHE_BATCH);
+    }
+}
+
+// Give every cached slot back to the pool, e.g. when the thread exits
+void poolCacheFlush(PoolCache* cache) {
+    returnSlots(cache, cache->count);
+}
+
+/* ---------- Chapter 11 node types allocated from pools ---------- */
+
+// Copies of the list node from example_linked_list.c and the BST node from
+// example_binary_search_tree.c (renamed so both fit in one program). Only
+// the allocation calls change: malloc() and free() become pool calls.
+
+struct Node {
+    int data;
+    struct Node* next;
+};
+
+struct TreeNode {
+    int data;
+    struct TreeNode* left;
+    struct TreeNode* right;
+};
+
+static Pool listPool;
+static Pool treePool;
+
+struct Node* createNode(int data) {
+    struct Node* newNode = (struct Node*)poolAlloc(&listPool);
+    newNode->data = data;
+    newNode->next = NULL;
+    return newNode;
+}
+
+struct TreeNode* createTreeNode(int data) {
+    struct TreeNode* newNode = (struct TreeNode*)poolAlloc(&treePool);
+    newNode->data = data;
+    newNode->left = NULL;
+    newNode->right = NULL;
+    return newNode;
+}
+
+struct TreeNode* insert(struct TreeNode* root, int data) {
+    if (root == NULL) {
+        return createTreeNode(data);
+    }
+    if (data < root->data) {
+        root->left = insert(root->left, data);
+    } else if (data > root->data) {
+        root->right = insert(root->right, data);
+    }
+    return root;
+}
+
+void freeTree(struct TreeNode* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        poolFree(&treePool, root);
+    }
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long residentKiB(void) {
+    long pages = 0, resident = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (file != NULL) {
+        if (fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(file);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+typedef struct {
+    Pool* pool;
+    int iterations;
+} ThreadArgs;
+
+// Producer/consumer style churn through a private cache
+static void* cacheWorker(void* arg) {
+    ThreadArgs* args = (ThreadArgs*)arg;
+    PoolCache cache;
+    void* live[256];
+
+    poolCacheInit(&cache, args->pool);
+    for (int i = 0; i < args->iterations; i++) {
+        for (int j = 0; j < 256; j++) live[j] = poolCacheAlloc(&cache);
+        for (int j = 0; j < 256; j++) poolCacheFree(&cache, live[j]);
+    }
+    poolCacheFlush(&cache);
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+    long n = argc > 1 ? atol(argv[1]) : 10000000;
+
+    poolInit(&listPool, sizeof(struct Node));
+    poolInit(&treePool, sizeof(struct TreeNode));
+
+    // The chapter's BST, now allocating its nodes from a pool
+    struct TreeNode* root = NULL;
+    int keys[] = {50, 30, 20, 40, 70, 60, 80};
+    for (int i = 0; i < 7; i++) {
+        root = insert(root, keys[i]);
+    }
+    printf("BST built from pool: root=%d, left=%d, right=%d\n", root->data, root->left->data, root->right->data);
+    freeTree(root);
+
+    // malloc: one heap allocation per list node
+    long rssBefore = residentKiB();
+    double start = nowSeconds();
+    struct Node* head = NULL;
+    for (long i = 0; i < n; i++) {
+        struct Node* node = (struct Node*)malloc(sizeof(struct Node));
+        node->data = (int)i;
+        node->next = head;
+        head = node;
+    }
+    double mallocAlloc = nowSeconds() - start;
+    long mallocRss = residentKiB() - rssBefore;
+
+    start = nowSeconds();
+    while (head != NULL) {
+        struct Node* next = head->next;
+        free(head);
+        head = next;
+    }
+    double mallocFree = nowSeconds() - start;
+    malloc_trim(0);
+
+    // Pool: the same list built with createNode()
+    rssBefore = residentKiB();
+    start = nowSeconds();
+    for (long i = 0; i < n; i++) {
+        struct Node* node = createNode((int)i);
+        node->next = head;
+        head = node;
+    }
+    double poolAllocTime = nowSeconds() - start;
+    long poolRss = residentKiB() - rssBefore;
+
+    start = nowSeconds();
+    while (head != NULL) {
+        struct Node* next = head->next;
+        poolFree(&listPool, head);
+        head = next;
+    }
+    double poolFreeTime = nowSeconds() - start;
+
+    printf("\n%ld list nodes of %zu bytes\n", n, sizeof(struct Node));
+    printf("%-8s %14s %14s %14s\n", "", "alloc ns", "free ns", "RSS MiB");
+    printf("%-8s %14.1f %14.1f %14.1f\n", "malloc", mallocAlloc * 1e9 / n, mallocFree * 1e9 / n, mallocRss / 1024.0);
+    printf("%-8s %14.1f %14.1f %14.1f (%zu slabs)\n", "pool", poolAllocTime * 1e9 / n, poolFreeTime * 1e9 / n,
+           poolRss / 1024.0, listPool.slabCount);
+
+    // Several threads sharing one pool through per-thread caches
+    int threads = 4;
+    pthread_t tids[4];
+    ThreadArgs args = {&listPool, 20000};
+    start = nowSeconds();
+    for (int i = 0; i < threads; i++) pthread_create(&tids[i], NULL, cacheWorker, &args);
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    double cached = nowSeconds() - start;
+    printf("%d threads with caches: %.1f ns per alloc+free\n", threads,
+           cached * 1e9 / ((double)threads * args.iterations * 256));
+
+    poolDestroy(&listPool);
+    poolDestroy(&treePool);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Buffers at least this large live in their own mmap() region and grow with
+// mremap(), which moves page table entries instead of copying the data.
+#define VECTOR_MAP_THRESHOLD (1UL << 20)
+
+static size_t pageSize(void) {
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// Resize a buffer of *capacityBytes to at least needBytes. *mapped tracks
+// whether the buffer came from mmap() (and so must be resized with mremap()).
+// Returns the new buffer, or NULL on failure (the old buffer is kept).
+void* vectorResizeRaw(void* data, size_t usedBytes, size_t* capacityBytes, size_t needBytes,
+                      int* mapped, size_t mapThreshold) {
+    if (needBytes >= mapThreshold) {
+        size_t bytes = (needBytes + pageSize() - 1) & ~(pageSize() - 1);
+        void* result;
+        if (*mapped) {
+            result = mremap(data, *capacityBytes, bytes, MREMAP_MAYMOVE);
+        } else {
+            // Crossing the threshold costs one copy; after that growth is free
+            result = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (result != MAP_FAILED) {
+                memcpy(result, data, usedBytes);
+                free(data);
+            }
+        }
+        if (result == MAP_FAILED) {
+            return NULL;
+        }
+        *mapped = 1;
+        *capacityBytes = bytes;
+        return result;
+    }
+
+    if (*mapped) {
+        // Shrinking below the threshold: move back to the heap
+        void* result = malloc(needBytes);
+        if (result == NULL) {
+            return NULL;
+        }
+        memcpy(result, data, usedBytes < needBytes ? usedBytes : needBytes);
+        munmap(data, *capacityBytes);
+        *mapped = 0;
+        *capacityBytes = needBytes;
+        return result;
+    }
+
+    void* result = realloc(data, needBytes);
+    if (result == NULL && needBytes != 0) {
+        return NULL;
+    }
+    *capacityBytes = needBytes;
+    return result;
+}
+
+void vectorReleaseRaw(void* data, size_t capacityBytes, int mapped) {
+    if (mapped) {
+        munmap(data, capacityBytes);
+    } else {
+        free(data);
+    }
+}
+
+// Generates a vector type NAME holding elements of TYPE, with functions
+// NAME##Init, NAME##Reserve, NAME##Push, NAME##Append, NAME##ShrinkToFit
+// and NAME##Free. Functions returning int give 0 on success, -1 on failure.
+#define DEFINE_VECTOR(NAME, TYPE)                                                         \
+    typedef struct {                                                                      \
+        TYPE* data;                                                                       \
+        size_t size;                                                                      \
+        size_t capacity;                                                                  \
+        size_t capacityBytes;                                                             \
+        size_t mapThreshold;                                                              \
+        int mapped;                                                                       \
+    } NAME;                                                                               \
+                                                                                          \
+    static inline void NAME##Init(NAME* v) {                                              \
+        v->data = NULL;                                                                   \
+        v->size = v->capacity = v->capacityBytes = 0;                                     \
+        v->mapThreshold = VECTOR_MAP_THRESHOLD;                                           \
+        v->mapped = 0;                                                                    \
+    }                                                                                     \
+                                                                                          \
+    static inline int NAME##Reserve(NAME* v, size_t count) {                              \
+        if (count <= v->capacity) {                                                       \
+            return 0;                                                                     \
+        }                                                                                 \
+        void* data = vectorResizeRaw(v->data, v->size * sizeof(TYPE), &v->capacityBytes, \
+                                     count * sizeof(TYPE), &v->mapped, v->mapThreshold);  \
+        if (data == NULL) {                                                               \
+            return -1;                                                                    \
+        }                                                                                 \
+        v->data = (TYPE*)data;                                                            \
+        v->capacity = v->capacityBytes / sizeof(TYPE);                                    \
+        return 0;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    /* Double the capacity so n pushes cost O(n) copying in total */                      \
+    static inline int NAME##Grow(NAME* v, size_t minCount) {                              \
+        size_t count = v->capacity ? v->capacity * 2 : 16;                                \
+        if (count < minCount) {                                                           \
+            count = minCount;                                                             \
+        }                                                                                 \
+        return NAME##Reserve(v, count);                                                   \
+    }                                                                                     \
+                                                                                          \
+    static inline int NAME##Push(NAME* v, TYPE value) {                                   \
+        if (v->size == v->capacity && NAME##Grow(v, v->size + 1) != 0) {                  \
+            return -1;                                                                    \
+        }                                                                                 \
+        v->data[v->size++] = value;                                                       \
+        return 0;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    /* Batch append: at most one resize and one memcpy */                                 \
+    static inline int NAME##Append(NAME* v, const TYPE* values, size_t count) {           \
+        if (v->size + count > v->capacity && NAME##Grow(v, v->size + count) != 0) {       \
+            return -1;                                                                    \
+        }                                                                                 \
+        memcpy(v->data + v->size, values, count * sizeof(TYPE));                          \
+        v->size += count;                                                                 \
+        return 0;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    static inline int NAME##ShrinkToFit(NAME* v) {                                        \
+        if (v->size == v->capacity) {                                                     \
+            return 0;                                                                     \
+        }                                                                                 \
+        void* data = vectorResizeRaw(v->data, v->size * sizeof(TYPE), &v->capacityBytes, \
+                                     v->size * sizeof(TYPE), &v->mapped, v->mapThreshold);\
+        if (data == NULL && v->size != 0) {                                               \
+            return -1;                                                                    \
+        }                                                                                 \
+        v->data = (TYPE*)data;                                                            \
+        v->capacity = v->capacityBytes / sizeof(TYPE);                                    \
+        return 0;                                                                         \
+    }                                                                                     \
+                                                                                          \
+    static inline void NAME##Free(NAME* v) {                                              \
+        vectorReleaseRaw(v->data, v->capacityBytes, v->mapped);                           \
+        NAME##Init(v);                                                                    \
+    }
+
+DEFINE_VECTOR(IntVector, int)
+
+typedef struct {
+    double x, y;
+} Point;
+
+DEFINE_VECTOR(PointVector, Point)
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Append one int at a time, resizing to the exact new size like example_realloc.c
+static double appendExact(size_t n) {
+    double start = nowSeconds();
+    int* data = NULL;
+    for (size_t i = 0; i < n; i++) {
+        int* grown = (int*)realloc(data, (i + 1) * sizeof(int));
+        if (grown == NULL) {
+            free(data);
+            return -1;
+        }
+        data = grown;
+        data[i] = (int)i;
+    }
+    double elapsed = nowSeconds() - start;
+    free(data);
+    return elapsed;
+}
+
+static double appendVector(size_t n, size_t mapThreshold) {
+    IntVector v;
+    IntVectorInit(&v);
+    v.mapThreshold = mapThreshold;
+
+    double start = nowSeconds();
+    for (size_t i = 0; i < n; i++) {
+        if (IntVectorPush(&v, (int)i) != 0) {
+            IntVectorFree(&v);
+            return -1;
+        }
+    }
+    double elapsed = nowSeconds() - start;
+    IntVectorFree(&v);
+    return elapsed;
+}
+
+static void printRate(double seconds, size_t n) {
+    if (seconds < 0) {
+        printf(" %16s", "-");
+    } else {
+        printf(" %16.1f", n / seconds / 1e6);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxCount = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000000;
+    size_t exactLimit = 10000000;  // The exact-size version gets too slow past this
+
+    PointVector points;
+    PointVectorInit(&points);
+    for (int i = 0; i < 5; i++) {
+        Point p = {i, i * i};
+        PointVectorPush(&points, p);
+    }
+    Point more[3] = {{5, 25}, {6, 36}, {7, 49}};
+    PointVectorAppend(&points, more, 3);
+    printf("size=%zu capacity=%zu\n", points.size, points.capacity);
+    PointVectorShrinkToFit(&points);
+    printf("after shrink_to_fit: capacity=%zu, last=(%.0f, %.0f)\n\n", points.capacity,
+           points.data[points.size - 1].x, points.data[points.size - 1].y);
+    PointVectorFree(&points);
+
+    printf("Append throughput (million ints/s)\n");
+    printf("%12s %16s %16s %16s\n", "elements", "exact realloc", "x2 realloc", "x2 + mremap");
+    for (size_t n = 1000; n <= maxCount; n *= 10) {
+        printf("%12zu", n);
+        printRate(n <= exactLimit ? appendExact(n) : -1, n);
+        printRate(appendVector(n, (size_t)-1), n);
+        printRate(appendVector(n, VECTOR_MAP_THRESHOLD), n);
+        printf("\n");
+    }
+    return 0;
+}
\ No newline at end of file
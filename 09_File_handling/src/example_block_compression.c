@@ -0,0 +1,658 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define BLOCK_MAGIC 0x5A4B4C42u  // "BLKZ" when read as little-endian bytes
+#define BLOCK_VERSION 1
+#define BLOCK_HEADER_SIZE 32
+#define BLOCK_ENTRY_SIZE 16
+#define BLOCK_STORED_RAW 0x80000000u  // Index flag: block did not compress
+#define MAX_THREADS 256
+
+/*
+ * File layout (all integers little-endian):
+ *
+ *   offset 0     header, BLOCK_HEADER_SIZE bytes
+ *                u32 magic, u16 version, u16 flags (0), u32 blockSize,
+ *                u32 blockCount, u64 rawSize, u64 indexOffset
+ *   32           compressed blocks, back to back
+ *   indexOffset  blockCount entries of u64 offset, u32 storedSize
+ *                (BLOCK_STORED_RAW set: stored uncompressed), u32 rawSize
+ *
+ * Block i holds the raw bytes [i * blockSize, (i + 1) * blockSize) and can
+ * be decompressed on its own.
+ */
+
+static void putLe16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void putLe32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void putLe64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint16_t getLe16(const unsigned char* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t getLe32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t getLe64(const unsigned char* p) {
+    return (uint64_t)getLe32(p) | (uint64_t)getLe32(p + 4) << 32;
+}
+
+/* ---------- LZ codec ---------- */
+
+/*
+ * An LZ77 codec with the sequence format of LZ4. The compressed data is a
+ * list of sequences:
+ *
+ *   token        high 4 bits: literal count, low 4 bits: match length - 4
+ *                (15 means more length bytes follow: add bytes until one is < 255)
+ *   literals     copied as they are
+ *   offset       u16, distance back to the match (1..65535)
+ *
+ * The last sequence has only literals.
+ */
+
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 14
+#define LZ_LAST_LITERALS 5  // A block always ends with at least 5 literals
+#define LZ_MATCH_LIMIT 12   // No match starts in the last 12 bytes
+#define LZ_MAX_OFFSET 65535
+
+// Largest possible compressed size of size bytes
+static size_t lzBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+static inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static unsigned char* putLength(unsigned char* op, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *op++ = 255;
+    }
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+// Returns the new output position, or NULL if the sequence does not fit
+static unsigned char* writeSequence(unsigned char* op, unsigned char* end, const unsigned char* literals,
+                                    size_t literalCount, size_t offset, size_t matchLength) {
+    size_t worst = 1 + literalCount / 255 + 1 + literalCount + 2 + matchLength / 255 + 1;
+    if ((size_t)(end - op) < worst) {
+        return NULL;
+    }
+    unsigned char* token = op++;
+    unsigned char high = literalCount < 15 ? (unsigned char)literalCount : 15;
+    if (literalCount >= 15) {
+        op = putLength(op, literalCount - 15);
+    }
+    memcpy(op, literals, literalCount);
+    op += literalCount;
+
+    unsigned char low = 0;
+    if (matchLength > 0) {
+        putLe16(op, (uint16_t)offset);
+        op += 2;
+        size_t extra = matchLength - LZ_MIN_MATCH;
+        low = extra < 15 ? (unsigned char)extra : 15;
+        if (extra >= 15) {
+            op = putLength(op, extra - 15);
+        }
+    }
+    *token = (unsigned char)(high << 4 | low);
+    return op;
+}
+
+// Compress size bytes into dst. Returns the compressed size, or 0 if it
+// would not fit in capacity bytes.
+size_t lzCompress(const unsigned char* src, size_t size, unsigned char* dst, size_t capacity) {
+    uint32_t table[1 << LZ_HASH_BITS];  // Last position of each 4-byte hash
+    memset(table, 0, sizeof(table));
+    const unsigned char* ip = src;
+    const unsigned char* anchor = src;  // Start of the pending literals
+    const unsigned char* end = src + size;
+    const unsigned char* matchLimit = size > LZ_MATCH_LIMIT ? end - LZ_MATCH_LIMIT : src;
+    const unsigned char* matchEnd = end - LZ_LAST_LITERALS;
+    unsigned char* op = dst;
+    unsigned char* oend = dst + capacity;
+
+    while (ip < matchLimit) {
+        uint32_t h = hash4(read32(ip));
+        const unsigned char* ref = src + table[h];
+        table[h] = (uint32_t)(ip - src);
+        if (ref >= ip || ip - ref > LZ_MAX_OFFSET || read32(ref) != read32(ip)) {
+            // No match: step faster through data that does not compress
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+            ip--;
+            ref--;
+        }
+        // Extend the match 8 bytes at a time; the first differing byte is
+        // the lowest set bit of the XOR
+        const unsigned char* mp = ip + LZ_MIN_MATCH;
+        const unsigned char* mr = ref + LZ_MIN_MATCH;
+        for (;;) {
+            if (mp + 8 <= matchEnd) {
+                uint64_t diff = read64(mp) ^ read64(mr);
+                if (diff == 0) {
+                    mp += 8;
+                    mr += 8;
+                    continue;
+                }
+                mp += __builtin_ctzll(diff) / 8;
+                break;
+            }
+            while (mp < matchEnd && *mp == *mr) {
+                mp++;
+                mr++;
+            }
+            break;
+        }
+
+        op = writeSequence(op, oend, anchor, ip - anchor, ip - ref, mp - ip);
+        if (op == NULL) {
+            return 0;
+        }
+        ip = anchor = mp;
+        if (ip < matchLimit) {
+            table[hash4(read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+        }
+    }
+
+    op = writeSequence(op, oend, anchor, end - anchor, 0, 0);
+    return op == NULL ? 0 : (size_t)(op - dst);
+}
+
+// Decompress into dst. Every length and offset is checked, so corrupt data
+// gives -1 instead of a read or write outside the buffers.
+long lzDecompress(const unsigned char* src, size_t size, unsigned char* dst, size_t capacity) {
+    const unsigned char* ip = src;
+    const unsigned char* iend = src + size;
+    unsigned char* op = dst;
+    unsigned char* oend = dst + capacity;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                literals += b;
+            } while (b == 255);
+        }
+        if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op)) {
+            return -1;
+        }
+        memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == iend) {
+            break;  // The last sequence has no match
+        }
+
+        if (iend - ip < 2) {
+            return -1;
+        }
+        size_t offset = getLe16(ip);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return -1;
+        }
+        size_t length = token & 15;
+        if (length == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+        }
+        length += LZ_MIN_MATCH;
+        if (length > (size_t)(oend - op)) {
+            return -1;
+        }
+
+        const unsigned char* match = op - offset;
+        if (offset >= 8 && (size_t)(oend - op) >= length + 8) {
+            // 8-byte copies may write up to 7 bytes past the match, which
+            // the next sequence overwrites
+            for (size_t i = 0; i < length; i += 8) {
+                memcpy(op + i, match + i, 8);
+            }
+        } else {
+            // Overlapping match (e.g. offset 1 repeats one byte)
+            for (size_t i = 0; i < length; i++) {
+                op[i] = match[i];
+            }
+        }
+        op += length;
+    }
+    return (long)(op - dst);
+}
+
+/* ---------- Parallel loop ---------- */
+
+typedef void (*ParallelJob)(void* context, size_t item);
+
+typedef struct {
+    ParallelJob job;
+    void* context;
+    size_t count;
+    _Atomic size_t next;
+} ParallelFor;
+
+static void* parallelWorker(void* arg) {
+    ParallelFor* p = (ParallelFor*)arg;
+    for (size_t i; (i = atomic_fetch_add(&p->next, 1)) < p->count;) {
+        p->job(p->context, i);
+    }
+    return NULL;
+}
+
+// Run job(context, i) for i in [0, count) on up to threads threads
+static void parallelFor(size_t count, int threads, ParallelJob job, void* context) {
+    ParallelFor p = {job, context, count, 0};
+    pthread_t tids[MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads && i < MAX_THREADS && (size_t)i < count; i++) {
+        if (pthread_create(&tids[started], NULL, parallelWorker, &p) == 0) {
+            started++;
+        }
+    }
+    parallelWorker(&p);  // The calling thread works too
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+}
+
+/* ---------- Writer ---------- */
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    uint32_t blockSize;
+    size_t firstBlock;
+    unsigned char** output;  // Compressed block, or the raw data
+    uint32_t* stored;        // Stored size, with BLOCK_STORED_RAW
+} CompressBatch;
+
+static void compressBlock(void* context, size_t item) {
+    CompressBatch* batch = (CompressBatch*)context;
+    size_t start = (batch->firstBlock + item) * batch->blockSize;
+    size_t raw = batch->size - start < batch->blockSize ? batch->size - start : batch->blockSize;
+    size_t n = lzCompress(batch->data + start, raw, batch->output[item], lzBound(batch->blockSize));
+    if (n == 0 || n >= raw) {
+        batch->output[item] = (unsigned char*)batch->data + start;  // Store it as it is
+        batch->stored[item] = (uint32_t)raw | BLOCK_STORED_RAW;
+    } else {
+        batch->stored[item] = (uint32_t)n;
+    }
+}
+
+// Compress size bytes into a block file. Blocks are compressed threads * 4
+// at a time and written in order, so memory use does not grow with the file.
+// Returns 0 on success, -1 on error.
+int blockFileWrite(const char* path, const void* data, size_t size, uint32_t blockSize, int threads) {
+    if (blockSize == 0 || blockSize >= BLOCK_STORED_RAW || threads < 1 || threads > MAX_THREADS) {
+        return -1;
+    }
+    uint64_t blockCount = (size + blockSize - 1) / blockSize;
+    if (blockCount > UINT32_MAX) {
+        return -1;
+    }
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    size_t batchBlocks = (size_t)threads * 4;
+    unsigned char* buffers = (unsigned char*)malloc(batchBlocks * lzBound(blockSize));
+    unsigned char** output = (unsigned char**)malloc(batchBlocks * sizeof(unsigned char*));
+    uint32_t* stored = (uint32_t*)malloc(batchBlocks * sizeof(uint32_t));
+    unsigned char* index = (unsigned char*)malloc(blockCount * BLOCK_ENTRY_SIZE + 1);
+    int failed = buffers == NULL || output == NULL || stored == NULL || index == NULL;
+
+    unsigned char header[BLOCK_HEADER_SIZE] = {0};
+    failed = failed || fwrite(header, 1, BLOCK_HEADER_SIZE, file) != BLOCK_HEADER_SIZE;
+    uint64_t position = BLOCK_HEADER_SIZE;
+
+    CompressBatch batch = {(const unsigned char*)data, size, blockSize, 0, output, stored};
+    for (size_t first = 0; first < blockCount && !failed; first += batchBlocks) {
+        size_t count = blockCount - first < batchBlocks ? blockCount - first : batchBlocks;
+        for (size_t i = 0; i < count; i++) {
+            output[i] = buffers + i * lzBound(blockSize);
+        }
+        batch.firstBlock = first;
+        parallelFor(count, threads, compressBlock, &batch);
+
+        for (size_t i = 0; i < count && !failed; i++) {
+            uint32_t length = stored[i] & ~BLOCK_STORED_RAW;
+            size_t block = first + i;
+            unsigned char* entry = index + block * BLOCK_ENTRY_SIZE;
+            putLe64(entry, position);
+            putLe32(entry + 8, stored[i]);
+            putLe32(entry + 12, (uint32_t)(size - block * blockSize < blockSize ? size - block * blockSize : blockSize));
+            failed = fwrite(output[i], 1, length, file) != length;
+            position += length;
+        }
+    }
+
+    if (!failed) {
+        putLe32(header, BLOCK_MAGIC);
+        putLe16(header + 4, BLOCK_VERSION);
+        putLe32(header + 8, blockSize);
+        putLe32(header + 12, (uint32_t)blockCount);
+        putLe64(header + 16, size);
+        putLe64(header + 24, position);
+        failed = fwrite(index, BLOCK_ENTRY_SIZE, blockCount, file) != blockCount || fseek(file, 0, SEEK_SET) != 0 ||
+                 fwrite(header, 1, BLOCK_HEADER_SIZE, file) != BLOCK_HEADER_SIZE;
+    }
+    failed |= fclose(file) != 0;
+    free(buffers);
+    free(output);
+    free(stored);
+    free(index);
+    return failed ? -1 : 0;
+}
+
+/* ---------- Reader ---------- */
+
+typedef struct {
+    const unsigned char* map;
+    size_t size;
+    uint32_t blockSize;
+    uint32_t blockCount;
+    uint64_t rawSize;
+    const unsigned char* index;
+} BlockFile;
+
+typedef enum {
+    BLOCK_OK,
+    BLOCK_IO_ERROR,
+    BLOCK_BAD_MAGIC,
+    BLOCK_BAD_VERSION,
+    BLOCK_CORRUPT  // Sizes or offsets point outside the file
+} BlockStatus;
+
+BlockStatus blockFileOpen(BlockFile* bf, const char* path) {
+    memset(bf, 0, sizeof(*bf));
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return BLOCK_IO_ERROR;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size < BLOCK_HEADER_SIZE) {
+        close(fd);
+        return BLOCK_CORRUPT;
+    }
+    void* map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return BLOCK_IO_ERROR;
+    }
+    bf->map = (const unsigned char*)map;
+    bf->size = sb.st_size;
+
+    const unsigned char* h = bf->map;
+    uint64_t indexOffset = getLe64(h + 24);
+    bf->blockSize = getLe32(h + 8);
+    bf->blockCount = getLe32(h + 12);
+    bf->rawSize = getLe64(h + 16);
+
+    BlockStatus status = BLOCK_OK;
+    if (getLe32(h) != BLOCK_MAGIC) {
+        status = BLOCK_BAD_MAGIC;
+    } else if (getLe16(h + 4) == 0 || getLe16(h + 4) > BLOCK_VERSION) {
+        status = BLOCK_BAD_VERSION;
+    } else if (bf->blockSize == 0 || indexOffset < BLOCK_HEADER_SIZE || indexOffset > bf->size ||
+               (bf->size - indexOffset) / BLOCK_ENTRY_SIZE < bf->blockCount ||
+               (bf->rawSize + bf->blockSize - 1) / bf->blockSize != bf->blockCount) {
+        status = BLOCK_CORRUPT;
+    } else {
+        // Every block must lie before the index and have the expected raw
+        // size. A raw block stores exactly that many bytes, a compressed one
+        // fewer (the writer never keeps a compressed block that did not shrink).
+        bf->index = bf->map + indexOffset;
+        for (uint32_t i = 0; i < bf->blockCount && status == BLOCK_OK; i++) {
+            const unsigned char* entry = bf->index + (size_t)i * BLOCK_ENTRY_SIZE;
+            uint64_t offset = getLe64(entry);
+            uint32_t stored = getLe32(entry + 8);
+            uint64_t length = stored & ~BLOCK_STORED_RAW;
+            uint64_t raw = getLe32(entry + 12);
+            uint64_t left = bf->rawSize - (uint64_t)i * bf->blockSize;
+            if (offset < BLOCK_HEADER_SIZE || offset > indexOffset || length > indexOffset - offset ||
+                raw != (left < bf->blockSize ? left : bf->blockSize) ||
+                ((stored & BLOCK_STORED_RAW) ? length != raw : length == 0 || length >= raw)) {
+                status = BLOCK_CORRUPT;
+            }
+        }
+    }
+    if (status != BLOCK_OK) {
+        munmap(map, bf->size);
+        bf->map = NULL;
+    }
+    return status;
+}
+
+// Decompress block i into dst (room for blockSize bytes). Returns the
+// number of bytes, or -1 if the block is corrupt.
+long blockFileReadBlock(const BlockFile* bf, uint32_t i, unsigned char* dst) {
+    if (i >= bf->blockCount) {
+        return -1;
+    }
+    const unsigned char* entry = bf->index + (size_t)i * BLOCK_ENTRY_SIZE;
+    const unsigned char* block = bf->map + getLe64(entry);
+    uint32_t stored = getLe32(entry + 8);
+    uint32_t raw = getLe32(entry + 12);
+    if (stored & BLOCK_STORED_RAW) {
+        memcpy(dst, block, raw);
+        return raw;
+    }
+    long n = lzDecompress(block, stored, dst, raw);
+    return n == (long)raw ? n : -1;
+}
+
+// Copy length bytes starting at raw offset into dst, decompressing only the
+// blocks they lie in. scratch needs room for one block. Returns 0 or -1.
+int blockFileRead(const BlockFile* bf, uint64_t offset, void* dst, size_t length, unsigned char* scratch) {
+    if (offset > bf->rawSize || length > bf->rawSize - offset) {
+        return -1;
+    }
+    unsigned char* out = (unsigned char*)dst;
+    while (length > 0) {
+        uint32_t block = (uint32_t)(offset / bf->blockSize);
+        size_t within = offset % bf->blockSize;
+        long n = blockFileReadBlock(bf, block, scratch);
+        if (n < 0) {
+            return -1;
+        }
+        size_t take = (size_t)n - within < length ? (size_t)n - within : length;
+        memcpy(out, scratch + within, take);
+        out += take;
+        offset += take;
+        length -= take;
+    }
+    return 0;
+}
+
+typedef struct {
+    const BlockFile* bf;
+    unsigned char* dst;
+    _Atomic int errors;
+} DecompressAll;
+
+static void decompressBlock(void* context, size_t item) {
+    DecompressAll* all = (DecompressAll*)context;
+    unsigned char* dst = all->dst + item * all->bf->blockSize;
+    if (blockFileReadBlock(all->bf, (uint32_t)item, dst) < 0) {
+        atomic_fetch_add(&all->errors, 1);
+    }
+}
+
+// Decompress the whole file into dst (rawSize bytes), blocks in parallel.
+// Returns 0, or -1 if a block is corrupt.
+int blockFileDecompress(const BlockFile* bf, void* dst, int threads) {
+    DecompressAll all = {bf, (unsigned char*)dst, 0};
+    parallelFor(bf->blockCount, threads, decompressBlock, &all);
+    return atomic_load(&all.errors) == 0 ? 0 : -1;
+}
+
+void blockFileClose(BlockFile* bf) {
+    if (bf->map != NULL) {
+        munmap((void*)bf->map, bf->size);
+        bf->map = NULL;
+    }
+}
+
+/* ---------- Benchmark ---------- */
+
+// 64-byte person records, as written by example_record_file.c
+#define PERSON_SIZE 64
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void makeRecords(unsigned char* data, size_t count) {
+    static const char* names[] = {"John Doe", "Jane Smith", "Alice Johnson", "Bob Brown",
+                                  "Carol White", "Dan Green", "Eve Black", "Frank Moore"};
+    unsigned seed = 1;
+    for (size_t i = 0; i < count; i++) {
+        unsigned char* out = data + i * PERSON_SIZE;
+        seed = seed * 1103515245 + 12345;
+        memset(out, 0, PERSON_SIZE);
+        putLe32(out, (uint32_t)i);
+        putLe32(out + 4, 18 + (seed >> 16) % 70);
+        strcpy((char*)out + 8, names[(seed >> 8) % 8]);
+    }
+}
+
+// 1, 2, 4, ... and finally maxThreads itself
+static int nextThreadCount(int threads, int maxThreads) {
+    return threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = "records.blkz";
+    size_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 256;
+    uint32_t blockSize = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) << 10 : 256 << 10;
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int maxThreads = argc > 3 ? atoi(argv[3]) : cpus;
+
+    size_t count = (mib << 20) / PERSON_SIZE;
+    size_t size = count * PERSON_SIZE;
+    unsigned char* data = (unsigned char*)malloc(size);
+    unsigned char* check = (unsigned char*)malloc(size);
+    unsigned char* scratch = (unsigned char*)malloc(blockSize);
+    if (data == NULL || check == NULL || scratch == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    makeRecords(data, count);
+
+    // Uncompressed reference: fwrite() and fread() of the same records
+    FILE* file = fopen("records.bin", "wb");
+    double start = nowSeconds();
+    fwrite(data, 1, size, file);
+    fclose(file);
+    double rawWrite = nowSeconds() - start;
+    file = fopen("records.bin", "rb");
+    start = nowSeconds();
+    size_t got = fread(check, 1, size, file);
+    double rawRead = nowSeconds() - start;
+    fclose(file);
+    remove("records.bin");
+
+    printf("%zu records, %.1f MiB, %u KiB blocks, %d CPUs online\n", count, size / 1048576.0, blockSize >> 10, cpus);
+    printf("%-22s %12s %12s %8s\n", "", "write MB/s", "read MB/s", "ratio");
+    printf("%-22s %12.0f %12.0f %8.2f\n", "uncompressed fwrite", size / rawWrite / 1e6,
+           got == size ? size / rawRead / 1e6 : 0, 1.0);
+
+    for (int threads = 1; threads <= maxThreads; threads = nextThreadCount(threads, maxThreads)) {
+        start = nowSeconds();
+        if (blockFileWrite(path, data, size, blockSize, threads) != 0) {
+            perror("blockFileWrite");
+            return 1;
+        }
+        double writeTime = nowSeconds() - start;
+
+        BlockFile bf;
+        BlockStatus status = blockFileOpen(&bf, path);
+        if (status != BLOCK_OK) {
+            printf("blockFileOpen failed: status %d\n", status);
+            return 1;
+        }
+        memset(check, 0, size);
+        start = nowSeconds();
+        int failed = blockFileDecompress(&bf, check, threads);
+        double readTime = nowSeconds() - start;
+
+        char name[32];
+        snprintf(name, sizeof(name), "compressed, %d thread%s", threads, threads == 1 ? "" : "s");
+        printf("%-22s %12.0f %12.0f %8.2f%s\n", name, size / writeTime / 1e6, size / readTime / 1e6,
+               (double)size / bf.size, failed || memcmp(check, data, size) != 0 ? "  MISMATCH" : "");
+        blockFileClose(&bf);
+    }
+
+    // Seeking: read single records by decompressing only their block
+    BlockFile bf;
+    blockFileOpen(&bf, path);
+    unsigned char record[PERSON_SIZE];
+    int lookups = 1000, wrong = 0;
+    unsigned seed = 7;
+    start = nowSeconds();
+    for (int i = 0; i < lookups; i++) {
+        seed = seed * 1103515245 + 12345;
+        size_t k = seed % count;
+        if (blockFileRead(&bf, (uint64_t)k * PERSON_SIZE, record, PERSON_SIZE, scratch) != 0 ||
+            getLe32(record) != (uint32_t)k) {
+            wrong++;
+        }
+    }
+    printf("\nRandom record lookup: %.1f us each (%d wrong)\n", (nowSeconds() - start) / lookups * 1e6, wrong);
+    blockFileClose(&bf);
+
+    free(data);
+    free(check);
+    free(scratch);
+    remove(path);
+    return 0;
+}
\ No newline at end of file
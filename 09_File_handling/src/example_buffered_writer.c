@@ -0,0 +1,440 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+
+#define WRITER_BUFFER (1 << 20)  // 1 MiB per buffer
+#define LARGE_WRITE 8192         // Bigger writes skip the buffer
+#define NUMBER_MAX 32            // Room for any formatted number
+
+typedef struct {
+    int fd;
+    char* buffers[2];
+    int active;     // Buffer currently being filled
+    size_t used;
+    _Atomic int error;  // Sticky, like ferror(); also set by the flush thread
+
+    // Background flushing (double buffering)
+    int background;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    char* pending;  // Buffer handed to the flush thread, or NULL
+    size_t pendingLength;
+    int stop;
+} BufferedWriter;
+
+// write() until everything is written; handles short writes and EINTR
+static int writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        length -= n;
+    }
+    return 0;
+}
+
+// writev() in batches of IOV_MAX, resuming after short writes
+static int writevAll(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count < IOV_MAX ? count : IOV_MAX);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
+static void* flushThread(void* arg) {
+    BufferedWriter* w = (BufferedWriter*)arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->pending == NULL && !w->stop) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (w->pending == NULL) {
+            break;
+        }
+        char* data = w->pending;
+        size_t length = w->pendingLength;
+        pthread_mutex_unlock(&w->lock);
+
+        int failed = writeAll(w->fd, data, length) != 0;
+
+        pthread_mutex_lock(&w->lock);
+        w->error |= failed;
+        w->pending = NULL;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+// background = 1 writes full buffers from a second thread while the caller
+// keeps filling the other buffer. Returns 0 on success.
+int writerOpen(BufferedWriter* w, int fd, int background) {
+    memset(w, 0, sizeof(*w));
+    w->fd = fd;
+    w->buffers[0] = (char*)malloc(WRITER_BUFFER);
+    w->buffers[1] = background ? (char*)malloc(WRITER_BUFFER) : NULL;
+    if (w->buffers[0] == NULL || (background && w->buffers[1] == NULL)) {
+        free(w->buffers[0]);
+        free(w->buffers[1]);
+        return -1;
+    }
+    w->background = background;
+    if (background) {
+        pthread_mutex_init(&w->lock, NULL);
+        pthread_cond_init(&w->cond, NULL);
+        if (pthread_create(&w->thread, NULL, flushThread, w) != 0) {
+            w->background = 0;  // Fall back to flushing on the caller's thread
+        }
+    }
+    return 0;
+}
+
+// Wait until the flush thread has written the buffer it was given
+static void drainPending(BufferedWriter* w) {
+    if (!w->background) {
+        return;
+    }
+    pthread_mutex_lock(&w->lock);
+    while (w->pending != NULL) {
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+
+int writerFlush(BufferedWriter* w) {
+    if (w->used > 0) {
+        if (w->background) {
+            // Hand the full buffer over and switch to the other one
+            pthread_mutex_lock(&w->lock);
+            while (w->pending != NULL) {
+                pthread_cond_wait(&w->cond, &w->lock);
+            }
+            w->pending = w->buffers[w->active];
+            w->pendingLength = w->used;
+            pthread_cond_broadcast(&w->cond);
+            pthread_mutex_unlock(&w->lock);
+            w->active ^= 1;
+        } else if (writeAll(w->fd, w->buffers[0], w->used) != 0) {
+            w->error = 1;
+        }
+        w->used = 0;
+    }
+    return w->error ? -1 : 0;
+}
+
+// Write many fragments, e.g. pieces of a message kept in different places.
+// Small batches are copied; large ones go out with writev() without copying.
+void writerPutFragments(BufferedWriter* w, const struct iovec* fragments, int count) {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += fragments[i].iov_len;
+    }
+    if (w->used + total <= WRITER_BUFFER && total < LARGE_WRITE) {
+        for (int i = 0; i < count; i++) {
+            memcpy(w->buffers[w->active] + w->used, fragments[i].iov_base, fragments[i].iov_len);
+            w->used += fragments[i].iov_len;
+        }
+        return;
+    }
+
+    // One writev() call for the buffered bytes and the fragments
+    struct iovec* iov = (struct iovec*)malloc((count + 1) * sizeof(struct iovec));
+    if (iov == NULL) {
+        w->error = 1;
+        return;
+    }
+    drainPending(w);
+    iov[0].iov_base = w->buffers[w->active];
+    iov[0].iov_len = w->used;
+    memcpy(iov + 1, fragments, count * sizeof(struct iovec));
+    if (writevAll(w->fd, iov, count + 1) != 0) {
+        w->error = 1;
+    }
+    w->used = 0;
+    free(iov);
+}
+
+static inline void writerPut(BufferedWriter* w, const char* data, size_t length) {
+    if (w->used + length <= WRITER_BUFFER) {
+        memcpy(w->buffers[w->active] + w->used, data, length);
+        w->used += length;
+    } else if (length < LARGE_WRITE) {
+        writerFlush(w);
+        memcpy(w->buffers[w->active], data, length);
+        w->used = length;
+    } else {
+        struct iovec fragment = {(void*)data, length};
+        writerPutFragments(w, &fragment, 1);
+    }
+}
+
+static inline void writerPutChar(BufferedWriter* w, char c) {
+    if (w->used == WRITER_BUFFER) {
+        writerFlush(w);
+    }
+    w->buffers[w->active][w->used++] = c;
+}
+
+// Room for at least NUMBER_MAX bytes at the end of the buffer
+static inline char* reserve(BufferedWriter* w) {
+    if (w->used + NUMBER_MAX > WRITER_BUFFER) {
+        writerFlush(w);
+    }
+    return w->buffers[w->active] + w->used;
+}
+
+static const char digitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Format an unsigned number two digits at a time; returns the length
+static int formatUnsigned(char* out, uint64_t value) {
+    char temp[20];
+    char* p = temp + sizeof(temp);
+    while (value >= 100) {
+        p -= 2;
+        memcpy(p, digitPairs + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, digitPairs + value * 2, 2);
+    } else {
+        *--p = (char)('0' + value);
+    }
+    int length = (int)(temp + sizeof(temp) - p);
+    memcpy(out, p, length);
+    return length;
+}
+
+void writerPutInt(BufferedWriter* w, int64_t value) {
+    char* out = reserve(w);
+    int length = 0;
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0) {
+        out[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    w->used += length + formatUnsigned(out + length, magnitude);
+}
+
+// Fixed-point output with the same digits as printf("%.*f"). The fast path
+// handles decimals <= 9 and |value| * 10^decimals below 2^53, where every
+// integer is exact; everything else goes through snprintf.
+void writerPutDouble(BufferedWriter* w, double value, int decimals) {
+    static const double scales[10] = {1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    int fast = isfinite(value) && decimals >= 0 && decimals <= 9;
+    double product = fast ? fabs(value) * scales[decimals] : 0;
+    // The product is off by up to half an ulp, so when it lies that close to
+    // a half only printf knows which way the exact value rounds (2.675 is
+    // really 2.67499..., but 2.675 * 100 gives 267.5)
+    if (!fast || !(product < 9007199254740992.0) ||
+        fabs(product - floor(product) - 0.5) <= product * DBL_EPSILON) {
+        char text[NUMBER_MAX + 300];  // Rare cases: let snprintf handle them
+        int length = snprintf(text, sizeof(text), "%.*f", decimals < 0 ? 6 : decimals, value);
+        writerPut(w, text, length);
+        return;
+    }
+    char* out = reserve(w);
+    int length = 0;
+    if (signbit(value)) {
+        out[length++] = '-';
+    }
+    // Round once on the scaled value so carries like 9.999 -> "10.00" work
+    uint64_t scaled = (uint64_t)nearbyint(product);
+    uint64_t whole = scaled / (uint64_t)scales[decimals];
+    uint64_t fraction = scaled % (uint64_t)scales[decimals];
+    length += formatUnsigned(out + length, whole);
+    if (decimals > 0) {
+        out[length++] = '.';
+        for (int i = decimals - 1; i >= 0; i--) {
+            out[length + i] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        length += decimals;
+    }
+    w->used += length;
+}
+
+// Flush, stop the flush thread and free the buffers (the fd stays open).
+// Returns -1 if any write failed.
+int writerClose(BufferedWriter* w) {
+    writerFlush(w);
+    if (w->background) {
+        pthread_mutex_lock(&w->lock);
+        w->stop = 1;
+        pthread_cond_broadcast(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread, NULL);
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->cond);
+    }
+    free(w->buffers[0]);
+    free(w->buffers[1]);
+    return w->error ? -1 : 0;
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double fileMiB(const char* path) {
+    struct stat sb;
+    return stat(path, &sb) == 0 ? sb.st_size / 1048576.0 : 0;
+}
+
+static void report(const char* name, const char* path, double seconds) {
+    printf("%-28s %8.1f MB/s\n", name, fileMiB(path) * 1.048576 / seconds);
+}
+
+// Values the fast path of writerPutDouble() must hand to snprintf or round
+// like printf; written after the records by every writer
+static const struct {
+    double value;
+    int decimals;
+} edgeCases[] = {{1e17, 2},   {123456789012.5, 9}, {9007199254740994.0, 1}, {-2.5, 0},
+                 {0.125, 2}, {2.675, 2},          {1.005, 2},             {-0.0, 3}};
+#define EDGE_CASES (int)(sizeof(edgeCases) / sizeof(edgeCases[0]))
+
+// Records written as "id,quantity,price\n", then the edge cases
+static void writeRecords(BufferedWriter* w, long records) {
+    for (long i = 0; i < records; i++) {
+        writerPutInt(w, i);
+        writerPutChar(w, ',');
+        writerPutInt(w, (i * 7919) % 100000 - 50000);
+        writerPutChar(w, ',');
+        writerPutDouble(w, (i % 100000) * 0.37, 2);
+        writerPutChar(w, '\n');
+    }
+    for (int i = 0; i < EDGE_CASES; i++) {
+        writerPutDouble(w, edgeCases[i].value, edgeCases[i].decimals);
+        writerPutChar(w, '\n');
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? atol(argv[1]) : 5000000;
+    const char* path = "writer_test.csv";
+
+    // Formatting check against printf
+    BufferedWriter w;
+    writerOpen(&w, STDOUT_FILENO, 0);
+    writerPut(&w, "Formatted: ", 11);
+    writerPutInt(&w, INT64_MIN);
+    writerPutChar(&w, ' ');
+    writerPutDouble(&w, -3.14159, 3);
+    writerPutChar(&w, ' ');
+    writerPutDouble(&w, 2.675, 2);
+    writerPutChar(&w, '\n');
+    writerClose(&w);
+    printf("printf:    %lld %.3f %.2f\n\n", (long long)INT64_MIN, -3.14159, 2.675);
+
+    // fprintf, one call per record
+    FILE* file = fopen(path, "w");
+    double start = nowSeconds();
+    for (long i = 0; i < records; i++) {
+        fprintf(file, "%ld,%ld,%.2f\n", i, (i * 7919) % 100000 - 50000, (i % 100000) * 0.37);
+    }
+    for (int i = 0; i < EDGE_CASES; i++) {
+        fprintf(file, "%.*f\n", edgeCases[i].decimals, edgeCases[i].value);
+    }
+    fclose(file);
+    report("fprintf per record", path, nowSeconds() - start);
+
+    // Copy the output as text to compare byte-at-a-time writers
+    file = fopen(path, "rb");
+    size_t size = (size_t)(fileMiB(path) * 1048576);
+    char* text = (char*)malloc(size);
+    if (text == NULL || fread(text, 1, size, file) != size) {
+        fprintf(stderr, "Could not read %s\n", path);
+        return 1;
+    }
+    fclose(file);
+
+    // fputc, as in example_fputc.c
+    file = fopen(path, "w");
+    start = nowSeconds();
+    for (size_t i = 0; i < size; i++) {
+        fputc(text[i], file);
+    }
+    fclose(file);
+    report("fputc per character", path, nowSeconds() - start);
+
+    // Writer, formatting the records itself
+    for (int background = 0; background <= 1; background++) {
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        start = nowSeconds();
+        writerOpen(&w, fd, background);
+        writeRecords(&w, records);
+        int failed = writerClose(&w);
+        close(fd);
+        report(background ? "writer, background flush" : "writer, formatting", path, nowSeconds() - start);
+        if (failed) {
+            printf("Write error\n");
+        }
+    }
+
+    // Check that the writer produced exactly what fprintf produced
+    file = fopen(path, "rb");
+    char* check = (char*)malloc(size);
+    int same = fileMiB(path) * 1048576 == (double)size && fread(check, 1, size, file) == size &&
+               memcmp(check, text, size) == 0;
+    fclose(file);
+    printf("Output identical to fprintf: %s\n", same ? "yes" : "no");
+
+    // Writing the text as fragments of 16 bytes, batched with writev()
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int count = (int)(size / 16);
+    struct iovec* fragments = (struct iovec*)malloc(count * sizeof(struct iovec));
+    for (int i = 0; i < count; i++) {
+        fragments[i].iov_base = text + i * 16;
+        fragments[i].iov_len = 16;
+    }
+    start = nowSeconds();
+    writerOpen(&w, fd, 0);
+    writerPutFragments(&w, fragments, count);
+    writerClose(&w);
+    close(fd);
+    report("writev, 16-byte fragments", path, nowSeconds() - start);
+
+    free(fragments);
+    free(check);
+    free(text);
+    remove(path);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <sys/resource.h>
+#include <linux/fs.h>
+
+#define COPY_BUFFER_SIZE (1 << 20)  // Fallback buffer and pipe size
+#define COPY_CHUNK (1 << 30)        // Largest request per system call
+
+// In the order they are tried: each one falls back to the next
+typedef enum {
+    COPY_REFLINK,          // Share the data blocks (Btrfs, XFS): no data is copied at all
+    COPY_FILE_RANGE,       // The kernel copies, possibly on the storage side (NFS, SMB)
+    COPY_SENDFILE,         // Kernel copies through the page cache
+    COPY_SPLICE,           // Kernel moves pages through a pipe
+    COPY_BUFFER,           // read() and write() through a user-space buffer
+    COPY_METHODS
+} CopyMethod;
+
+static const char* methodNames[COPY_METHODS] = {"reflink", "copy_file_range", "sendfile", "splice", "buffer"};
+
+// Errors that mean "this method does not work for these files", not "the copy failed"
+static int unsupported(int error) {
+    return error == ENOSYS || error == EOPNOTSUPP || error == ENOTTY || error == EXDEV || error == EINVAL ||
+           error == EBADF || error == ETXTBSY || error == ESPIPE;
+}
+
+// Only regular files have a file position to seek to and a size to truncate;
+// pipes and sockets are written in order instead
+static int isRegular(int fd) {
+    struct stat sb;
+    return fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode);
+}
+
+// Each method copies [*offset, size) and advances *offset as it goes, so a
+// method that stops halfway can hand over to the next one.
+// Returns 0 on success, -1 on error (errno is set).
+
+static int copyReflink(int in, int out, uint64_t* offset, uint64_t size) {
+    if (*offset != 0) {
+        errno = EINVAL;  // Only whole files can be cloned this way
+        return -1;
+    }
+    if (ioctl(out, FICLONE, in) != 0) {
+        return -1;
+    }
+    *offset = size;
+    return 0;
+}
+
+static int copyFileRange(int in, int out, uint64_t* offset, uint64_t size) {
+    while (*offset < size) {
+        loff_t inOffset = (loff_t)*offset, outOffset = (loff_t)*offset;
+        size_t chunk = size - *offset < COPY_CHUNK ? size - *offset : COPY_CHUNK;
+        ssize_t n = copy_file_range(in, &inOffset, out, &outOffset, chunk, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            break;  // The file got shorter while copying
+        }
+        *offset += n;
+    }
+    return 0;
+}
+
+static int copySendfile(int in, int out, uint64_t* offset, uint64_t size) {
+    if (isRegular(out) && lseek(out, (off_t)*offset, SEEK_SET) < 0) {  // sendfile() writes at the file position
+        return -1;
+    }
+    while (*offset < size) {
+        off_t inOffset = (off_t)*offset;
+        size_t chunk = size - *offset < COPY_CHUNK ? size - *offset : COPY_CHUNK;
+        ssize_t n = sendfile(out, in, &inOffset, chunk);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        *offset += n;
+    }
+    return 0;
+}
+
+static int copySplice(int in, int out, uint64_t* offset, uint64_t size) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        return -1;
+    }
+    fcntl(pipeFds[1], F_SETPIPE_SZ, COPY_BUFFER_SIZE);  // Fewer round trips than the default 64 KiB
+    int regular = isRegular(out);
+    int result = 0;
+    while (*offset < size && result == 0) {
+        loff_t inOffset = (loff_t)*offset;
+        size_t chunk = size - *offset < COPY_BUFFER_SIZE ? size - *offset : COPY_BUFFER_SIZE;
+        ssize_t n = splice(in, &inOffset, pipeFds[1], NULL, chunk, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            result = n < 0 ? -1 : 0;
+            break;
+        }
+        // Drain the pipe into the destination before reading more
+        for (ssize_t left = n; left > 0;) {
+            loff_t outOffset = (loff_t)*offset;
+            ssize_t m = splice(pipeFds[0], NULL, out, regular ? &outOffset : NULL, left, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (m < 0 && errno == EINTR) continue;
+            if (m <= 0) {
+                // *offset only counts bytes that reached out, so the next
+                // method starts again with the bytes still in the pipe
+                if (m == 0) errno = EIO;
+                result = -1;
+                break;
+            }
+            left -= m;
+            *offset += m;
+        }
+    }
+    int saved = errno;
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    errno = saved;
+    return result;
+}
+
+static int copyBuffer(int in, int out, uint64_t* offset, uint64_t size) {
+    char* buffer = (char*)malloc(COPY_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return -1;
+    }
+    int regular = isRegular(out);
+    int result = 0;
+    while (*offset < size) {
+        ssize_t n = pread(in, buffer, COPY_BUFFER_SIZE, (off_t)*offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            result = n < 0 ? -1 : 0;
+            break;
+        }
+        for (ssize_t done = 0; done < n;) {
+            ssize_t m = regular ? pwrite(out, buffer + done, n - done, (off_t)(*offset + done))
+                                : write(out, buffer + done, n - done);
+            if (m < 0 && errno == EINTR) continue;
+            if (m < 0) {
+                free(buffer);
+                return -1;
+            }
+            done += m;
+        }
+        *offset += n;
+    }
+    free(buffer);
+    return result;
+}
+
+typedef int (*CopyFunc)(int in, int out, uint64_t* offset, uint64_t size);
+static const CopyFunc copyFuncs[COPY_METHODS] = {copyReflink, copyFileRange, copySendfile, copySplice, copyBuffer};
+
+// Copy all of in (a regular file) to out, which may also be a pipe or a
+// socket, trying the methods from first onward until one works. *used is set
+// to the method that copied the last byte. Returns the number of bytes
+// copied, or -1 on error.
+long long copyFd(int in, int out, CopyMethod first, CopyMethod* used) {
+    struct stat sb;
+    if (fstat(in, &sb) != 0) {
+        return -1;
+    }
+    uint64_t size = sb.st_size;
+    uint64_t offset = 0;
+    for (int method = first; method < COPY_METHODS; method++) {
+        *used = (CopyMethod)method;
+        if (copyFuncs[method](in, out, &offset, size) == 0) {
+            // Drop anything left over in an existing, longer destination
+            if (isRegular(out) && ftruncate(out, (off_t)offset) != 0) {
+                return -1;
+            }
+            return (long long)offset;
+        }
+        if (!unsupported(errno)) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// Copy the file at from to to. Returns 0 on success, -1 on error.
+int copyFile(const char* from, const char* to, CopyMethod first, CopyMethod* used) {
+    int in = open(from, O_RDONLY);
+    if (in == -1) {
+        return -1;
+    }
+    struct stat sb;
+    int out = fstat(in, &sb) == 0 ? open(to, O_WRONLY | O_CREAT | O_TRUNC, sb.st_mode & 0777) : -1;
+    if (out == -1) {
+        close(in);
+        return -1;
+    }
+    posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+    long long copied = copyFd(in, out, first, used);
+    int failed = copied < 0;
+    failed |= close(out) != 0;
+    close(in);
+    return failed ? -1 : 0;
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// User plus system CPU time of this process
+static double cpuSeconds(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static int copyWithFgetc(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    FILE* out = in != NULL ? fopen(to, "wb") : NULL;
+    if (out == NULL) {
+        if (in != NULL) fclose(in);
+        return -1;
+    }
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        fputc(c, out);
+    }
+    fclose(in);
+    return fclose(out);
+}
+
+static int copyWithFread(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    FILE* out = in != NULL ? fopen(to, "wb") : NULL;
+    if (out == NULL) {
+        if (in != NULL) fclose(in);
+        return -1;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        fwrite(buffer, 1, n, out);
+    }
+    fclose(in);
+    return fclose(out);
+}
+
+static int sameContents(const char* a, const char* b) {
+    FILE* fa = fopen(a, "rb");
+    FILE* fb = fopen(b, "rb");
+    static char ba[1 << 16], bb[1 << 16];
+    int same = fa != NULL && fb != NULL;
+    while (same) {
+        size_t na = fread(ba, 1, sizeof(ba), fa);
+        size_t nb = fread(bb, 1, sizeof(bb), fb);
+        same = na == nb && memcmp(ba, bb, na) == 0;
+        if (na == 0) break;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return same;
+}
+
+static void report(const char* name, uint64_t bytes, double wall, double cpu, int ok) {
+    printf("  %-30s %10.0f MB/s %10.1f ms CPU%s\n", name, bytes / wall / 1e6, cpu * 1e3, ok ? "" : "  FAILED");
+}
+
+// 1, 16, 256, ... MiB and finally maxMib itself
+static uint64_t nextSize(uint64_t mib, uint64_t maxMib) {
+    return mib < maxMib && mib * 16 > maxMib ? maxMib : mib * 16;
+}
+
+int main(int argc, char* argv[]) {
+    const char* from = "copy_source.bin";
+    const char* to = "copy_target.bin";
+    uint64_t maxMib = argc > 1 ? strtoull(argv[1], NULL, 10) : 1024;
+
+    char* block = (char*)malloc(COPY_BUFFER_SIZE);
+    for (size_t i = 0; i < COPY_BUFFER_SIZE; i++) {
+        block[i] = (char)(i * 131 + (i >> 12));
+    }
+
+    for (uint64_t mib = 1; mib <= maxMib; mib = nextSize(mib, maxMib)) {
+        uint64_t bytes = mib << 20;
+        FILE* file = fopen(from, "wb");
+        for (uint64_t i = 0; i < mib; i++) {
+            block[0] = (char)i;  // Every MiB differs a little
+            fwrite(block, 1, COPY_BUFFER_SIZE, file);
+        }
+        fclose(file);
+        printf("%llu MiB (source in the page cache)\n", (unsigned long long)mib);
+
+        double wall, cpu;
+        if (mib <= 256) {  // Slow: about two function calls per byte
+            remove(to);
+            wall = nowSeconds();
+            cpu = cpuSeconds();
+            int ok = copyWithFgetc(from, to) == 0;
+            report("fgetc/fputc", bytes, nowSeconds() - wall, cpuSeconds() - cpu, ok && sameContents(from, to));
+        }
+        remove(to);
+        wall = nowSeconds();
+        cpu = cpuSeconds();
+        int ok = copyWithFread(from, to) == 0;
+        report("fread/fwrite, 4 KiB", bytes, nowSeconds() - wall, cpuSeconds() - cpu, ok && sameContents(from, to));
+
+        for (int method = COPY_METHODS - 1; method >= 0; method--) {
+            remove(to);
+            CopyMethod used;
+            wall = nowSeconds();
+            cpu = cpuSeconds();
+            ok = copyFile(from, to, (CopyMethod)method, &used) == 0;
+            wall = nowSeconds() - wall;
+            cpu = cpuSeconds() - cpu;
+            char name[64];
+            if ((int)used == method) {
+                snprintf(name, sizeof(name), "%s", methodNames[method]);
+            } else {
+                snprintf(name, sizeof(name), "%s -> %s", methodNames[method], methodNames[used]);
+            }
+            report(name, bytes, wall, cpu, ok && sameContents(from, to));
+        }
+        printf("\n");
+    }
+
+    free(block);
+    remove(from);
+    remove(to);
+    return 0;
+}
\ No newline at end of file
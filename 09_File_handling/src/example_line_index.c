@@ -0,0 +1,389 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define INDEX_MAGIC 0x5844494Cu  // "LIDX" when read as little-endian bytes
+#define INDEX_VERSION 1
+#define INDEX_HEADER_SIZE 48
+#define SCAN_BLOCK (1 << 20)
+#define TAIL_CHECK 64  // Bytes hashed to notice that the file was replaced, not appended to
+
+/*
+ * Sidecar file layout (all integers little-endian):
+ *
+ *   offset 0   header, INDEX_HEADER_SIZE bytes
+ *              u32 magic, u16 version, u16 reserved, u32 interval,
+ *              u32 reserved, u64 lines, u64 indexedBytes, u64 tailHash,
+ *              u64 count
+ *   48         count u64 offsets; entry i is the start of line i * interval
+ */
+
+static void putLe16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void putLe32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void putLe64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint16_t getLe16(const unsigned char* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t getLe32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t getLe64(const unsigned char* p) {
+    return (uint64_t)getLe32(p) | (uint64_t)getLe32(p + 4) << 32;
+}
+
+typedef struct {
+    uint32_t interval;      // One entry every interval lines
+    uint64_t lines;         // Complete lines covered by the index
+    uint64_t indexedBytes;  // End of the last complete line
+    uint64_t tailHash;      // Hash of the TAIL_CHECK bytes before indexedBytes
+    uint64_t* offsets;
+    size_t count;
+    size_t capacity;
+    size_t savedCount;      // Entries already in the sidecar file
+} LineIndex;
+
+static int addOffset(LineIndex* index, uint64_t offset) {
+    if (index->count == index->capacity) {
+        size_t capacity = index->capacity ? index->capacity * 2 : 1024;
+        uint64_t* grown = (uint64_t*)realloc(index->offsets, capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            return -1;
+        }
+        index->offsets = grown;
+        index->capacity = capacity;
+    }
+    index->offsets[index->count++] = offset;
+    return 0;
+}
+
+// FNV-1a hash of the bytes just before end
+static uint64_t hashTail(int fd, uint64_t end) {
+    unsigned char buffer[TAIL_CHECK];
+    uint64_t start = end > TAIL_CHECK ? end - TAIL_CHECK : 0;
+    ssize_t n = pread(fd, buffer, end - start, (off_t)start);
+    uint64_t hash = 14695981039346656037ULL;
+    for (ssize_t i = 0; i < n; i++) {
+        hash = (hash ^ buffer[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Stream the file from indexedBytes to its end, counting lines and adding
+// an entry at the start of every interval-th line
+static int scanFrom(LineIndex* index, int fd) {
+    char* buffer = (char*)malloc(SCAN_BLOCK);
+    if (buffer == NULL) {
+        return -1;
+    }
+    uint64_t position = index->indexedBytes;
+    ssize_t n;
+    while ((n = pread(fd, buffer, SCAN_BLOCK, (off_t)position)) > 0) {
+        const char* p = buffer;
+        const char* end = buffer + n;
+        while ((p = (const char*)memchr(p, '\n', end - p)) != NULL) {
+            p++;
+            index->lines++;
+            index->indexedBytes = position + (p - buffer);
+            if (index->lines % index->interval == 0 && addOffset(index, index->indexedBytes) != 0) {
+                free(buffer);
+                return -1;
+            }
+        }
+        position += n;
+    }
+    free(buffer);
+    if (n < 0) {
+        return -1;
+    }
+    index->tailHash = hashTail(fd, index->indexedBytes);
+    return 0;
+}
+
+// Build the index of path in one pass. Returns 0 on success, -1 on error.
+int lineIndexBuild(LineIndex* index, const char* path, uint32_t interval) {
+    free(index->offsets);
+    memset(index, 0, sizeof(*index));
+    index->interval = interval ? interval : 1;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    int result = addOffset(index, 0) == 0 ? scanFrom(index, fd) : -1;  // Line 0 starts at 0
+    close(fd);
+    return result;
+}
+
+// Index the lines appended to path since the last build or update. If the
+// file shrank or the indexed part changed, the index is built again.
+// Returns the number of new lines, or -1 on error.
+long lineIndexUpdate(LineIndex* index, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        close(fd);
+        return -1;
+    }
+    if ((uint64_t)sb.st_size < index->indexedBytes || hashTail(fd, index->indexedBytes) != index->tailHash) {
+        close(fd);
+        // savedCount is 0 again, so the next save rewrites the whole sidecar file
+        return lineIndexBuild(index, path, index->interval) == 0 ? (long)index->lines : -1;
+    }
+    uint64_t before = index->lines;
+    long result = scanFrom(index, fd) == 0 ? (long)(index->lines - before) : -1;
+    close(fd);
+    return result;
+}
+
+// Write the header and the entries added since the last save. Returns 0 on
+// success, -1 on error.
+int lineIndexSave(LineIndex* index, const char* indexPath) {
+    int fd = open(indexPath, O_WRONLY | O_CREAT | (index->savedCount == 0 ? O_TRUNC : 0), 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    size_t fresh = index->count - index->savedCount;
+    unsigned char* entries = (unsigned char*)malloc(fresh * 8 + 1);
+    int failed = entries == NULL;
+    if (!failed) {
+        for (size_t i = 0; i < fresh; i++) {
+            putLe64(entries + 8 * i, index->offsets[index->savedCount + i]);
+        }
+        off_t at = INDEX_HEADER_SIZE + (off_t)index->savedCount * 8;
+        failed = pwrite(fd, entries, fresh * 8, at) != (ssize_t)(fresh * 8);
+    }
+
+    // The header goes last: if the program stops before this, the file still
+    // holds the old, valid count and the new entries are simply ignored
+    unsigned char header[INDEX_HEADER_SIZE] = {0};
+    putLe32(header, INDEX_MAGIC);
+    putLe16(header + 4, INDEX_VERSION);
+    putLe32(header + 8, index->interval);
+    putLe64(header + 16, index->lines);
+    putLe64(header + 24, index->indexedBytes);
+    putLe64(header + 32, index->tailHash);
+    putLe64(header + 40, index->count);
+    failed = failed || pwrite(fd, header, INDEX_HEADER_SIZE, 0) != INDEX_HEADER_SIZE;
+    failed |= close(fd) != 0;
+    free(entries);
+    if (!failed) {
+        index->savedCount = index->count;
+    }
+    return failed ? -1 : 0;
+}
+
+// Load a sidecar file. Returns 0 on success, -1 if it is missing or invalid.
+int lineIndexLoad(LineIndex* index, const char* indexPath) {
+    memset(index, 0, sizeof(*index));
+    FILE* file = fopen(indexPath, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    unsigned char header[INDEX_HEADER_SIZE];
+    int ok = fread(header, 1, INDEX_HEADER_SIZE, file) == INDEX_HEADER_SIZE && getLe32(header) == INDEX_MAGIC &&
+             getLe16(header + 4) == INDEX_VERSION && getLe32(header + 8) > 0;
+    if (ok) {
+        index->interval = getLe32(header + 8);
+        index->lines = getLe64(header + 16);
+        index->indexedBytes = getLe64(header + 24);
+        index->tailHash = getLe64(header + 32);
+        uint64_t count = getLe64(header + 40);
+        // Entry count must match the line count, which also bounds the allocation
+        ok = count == index->lines / index->interval + 1;
+        unsigned char entry[8];
+        for (uint64_t i = 0; ok && i < count; i++) {
+            ok = fread(entry, 1, 8, file) == 8 && addOffset(index, getLe64(entry)) == 0;
+        }
+    }
+    fclose(file);
+    if (!ok) {
+        free(index->offsets);
+        memset(index, 0, sizeof(*index));
+        return -1;
+    }
+    index->savedCount = index->count;
+    return 0;
+}
+
+// Byte offset of line number line (counting from 0): one array lookup, then
+// a scan over at most interval - 1 lines. Returns -1 if the line is not indexed.
+long long lineIndexFind(const LineIndex* index, int fd, uint64_t line) {
+    if (line >= index->lines) {
+        return -1;
+    }
+    uint64_t position = index->offsets[line / index->interval];
+    uint64_t skip = line % index->interval;
+    char buffer[16384];
+    while (skip > 0) {
+        ssize_t n = pread(fd, buffer, sizeof(buffer), (off_t)position);
+        if (n <= 0) {
+            return -1;
+        }
+        const char* p = buffer;
+        const char* end = buffer + n;
+        while (skip > 0 && (p = (const char*)memchr(p, '\n', end - p)) != NULL) {
+            p++;
+            skip--;
+        }
+        position += skip == 0 ? (uint64_t)(p - buffer) : (uint64_t)n;
+    }
+    return (long long)position;
+}
+
+void lineIndexFree(LineIndex* index) {
+    free(index->offsets);
+    index->offsets = NULL;
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Without an index: count newlines from the start of the file
+static long long findLineByScan(int fd, uint64_t line) {
+    static char buffer[SCAN_BLOCK];
+    if (line == 0) {
+        return 0;
+    }
+    uint64_t position = 0;
+    ssize_t n;
+    while ((n = pread(fd, buffer, sizeof(buffer), (off_t)position)) > 0) {
+        const char* p = buffer;
+        const char* end = buffer + n;
+        while ((p = (const char*)memchr(p, '\n', end - p)) != NULL) {
+            p++;
+            if (--line == 0) {
+                return (long long)(position + (p - buffer));
+            }
+        }
+        position += n;
+    }
+    return -1;
+}
+
+// Every line starts with its own line number, then 20 to 219 characters
+static uint64_t appendLines(const char* path, uint64_t first, uint64_t bytes) {
+    FILE* file = fopen(path, "a");
+    char text[256];
+    uint64_t written = 0, line = first;
+    unsigned seed = (unsigned)first + 1;
+    for (; written < bytes; line++) {
+        seed = seed * 1103515245 + 12345;
+        int length = 20 + (seed >> 16) % 200;
+        memset(text, 'a' + (int)(line % 26), length);
+        written += fprintf(file, "%010llu %.*s\n", (unsigned long long)line, length, text);
+    }
+    fclose(file);
+    return line - first;
+}
+
+// Check that the line at offset really is the line with that number
+static int checkLine(int fd, long long offset, uint64_t line) {
+    char number[11] = {0};
+    return offset >= 0 && pread(fd, number, 10, offset) == 10 && strtoull(number, NULL, 10) == line;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = "lines_index_test.txt";
+    const char* indexPath = "lines_index_test.txt.idx";
+    uint64_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 1024;
+    uint32_t interval = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 1000;
+
+    remove(path);
+    remove(indexPath);
+    uint64_t lines = appendLines(path, 0, mib << 20);
+
+    LineIndex index = {0};
+    double start = nowSeconds();
+    if (lineIndexBuild(&index, path, interval) != 0 || lineIndexSave(&index, indexPath) != 0) {
+        perror("lineIndexBuild");
+        return 1;
+    }
+    double buildTime = nowSeconds() - start;
+    struct stat sb;
+    stat(indexPath, &sb);
+    printf("%s: %llu MiB, %llu lines\n", path, (unsigned long long)mib, (unsigned long long)index.lines);
+    printf("Index every %u lines: %zu entries, %lld bytes, built in %.2f s\n\n", interval, index.count,
+           (long long)sb.st_size, buildTime);
+
+    int fd = open(path, O_RDONLY);
+    int scans = 10, seeks = 100000, wrong = 0;
+    unsigned seed = 5;
+
+    // Without the index every seek reads on average half the file
+    start = nowSeconds();
+    for (int i = 0; i < scans; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint64_t line = seed % lines;
+        wrong += !checkLine(fd, findLineByScan(fd, line), line);
+    }
+    double scanTime = (nowSeconds() - start) / scans;
+
+    // The sidecar file is loaded once, e.g. when a viewer opens the file
+    LineIndex loaded;
+    if (lineIndexLoad(&loaded, indexPath) != 0) {
+        printf("Could not load %s\n", indexPath);
+        return 1;
+    }
+    start = nowSeconds();
+    for (int i = 0; i < seeks; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint64_t line = seed % lines;
+        wrong += !checkLine(fd, lineIndexFind(&loaded, fd, line), line);
+    }
+    double seekTime = (nowSeconds() - start) / seeks;
+    printf("%-24s %14.1f us\n", "seek without index", scanTime * 1e6);
+    printf("%-24s %14.1f us\n", "seek with index", seekTime * 1e6);
+    close(fd);
+
+    // Append 10% more lines and update the index incrementally
+    uint64_t added = appendLines(path, lines, (mib << 20) / 10);
+    start = nowSeconds();
+    long updated = lineIndexUpdate(&loaded, path);
+    int saved = lineIndexSave(&loaded, indexPath);
+    double updateTime = nowSeconds() - start;
+    printf("\nAppended %llu lines; incremental update found %ld in %.3f s (%s)\n", (unsigned long long)added, updated,
+           updateTime, saved == 0 ? "saved" : "save failed");
+
+    fd = open(path, O_RDONLY);
+    LineIndex reloaded;
+    lineIndexLoad(&reloaded, indexPath);
+    for (uint64_t line = lines - 5; line < lines + added; line += added / 7 + 1) {
+        wrong += !checkLine(fd, lineIndexFind(&reloaded, fd, line), line);
+    }
+    wrong += !checkLine(fd, lineIndexFind(&reloaded, fd, lines + added - 1), lines + added - 1);
+    printf("Lines found at the wrong offset: %d\n", wrong);
+    close(fd);
+
+    lineIndexFree(&index);
+    lineIndexFree(&loaded);
+    lineIndexFree(&reloaded);
+    remove(path);
+    remove(indexPath);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define BLOCK_SIZE (1 << 20)  // Read size when the file cannot be mapped
+#define TEST_FILE_SIZE ((size_t)256 << 20)  // Generated when no file is given
+
+// A line inside the reader's memory; not NUL-terminated
+typedef struct {
+    const char* data;
+    size_t length;
+} StringView;
+
+typedef struct {
+    int fd;
+    int mapped;
+    char* data;      // Whole file when mapped, otherwise the read buffer
+    size_t size;     // Bytes available in data
+    size_t pos;      // Start of the next line
+    size_t scan;     // Where the search for its '\n' resumes (pos <= scan <= size)
+    size_t capacity; // Size of the read buffer
+    int eof;
+} LineReader;
+
+// Find the first '\n' in [p, end), or return end
+static const char* findNewline(const char* p, const char* end) {
+#ifdef __AVX2__
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; p + 32 <= end; p += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; p + 16 <= end; p += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+    const char* hit = (const char*)memchr(p, '\n', end - p);
+    return hit ? hit : end;
+}
+
+// useMap = 0 forces block reads. Returns 0 on success, -1 on error (errno is set)
+int lineReaderOpen(LineReader* reader, const char* path, int useMap) {
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = open(path, O_RDONLY);
+    if (reader->fd == -1) {
+        return -1;
+    }
+
+    struct stat sb;
+    if (useMap && fstat(reader->fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+        void* data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, reader->fd, 0);
+        if (data != MAP_FAILED) {
+            // Read ahead aggressively and drop pages soon after they are used
+            madvise(data, sb.st_size, MADV_SEQUENTIAL);
+            reader->mapped = 1;
+            reader->data = (char*)data;
+            reader->size = sb.st_size;
+            reader->eof = 1;
+            return 0;
+        }
+    }
+
+    // Pipes, terminals and empty files: read large blocks instead
+    posix_fadvise(reader->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    reader->capacity = BLOCK_SIZE;
+    reader->data = (char*)malloc(reader->capacity);
+    if (reader->data == NULL) {
+        close(reader->fd);
+        return -1;
+    }
+    return 0;
+}
+
+// Move the unfinished line to the front of the buffer and read more after it
+static int refillBlock(LineReader* reader) {
+    size_t left = reader->size - reader->pos;
+    memmove(reader->data, reader->data + reader->pos, left);
+    reader->scan -= reader->pos;
+    reader->pos = 0;
+    reader->size = left;
+
+    if (left == reader->capacity) {
+        // One line fills the whole buffer: grow it, lines have no length limit
+        char* grown = (char*)realloc(reader->data, reader->capacity * 2);
+        if (grown == NULL) {
+            return -1;
+        }
+        reader->data = grown;
+        reader->capacity *= 2;
+    }
+
+    ssize_t n;
+    do {
+        n = read(reader->fd, reader->data + reader->size, reader->capacity - reader->size);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return -1;
+    }
+    if (n == 0) {
+        reader->eof = 1;
+    }
+    reader->size += n;
+    return 0;
+}
+
+// Get the next line without its '\n'. Returns 1 for a line, 0 at the end of
+// the file, -1 on a read error. In block mode the view is only valid until
+// the next call; in mapped mode it stays valid until lineReaderClose().
+int lineReaderNext(LineReader* reader, StringView* line) {
+    for (;;) {
+        const char* start = reader->data + reader->pos;
+        const char* end = reader->data + reader->size;
+        // Bytes already searched before a refill are not searched again, so
+        // a long line arriving in small reads costs linear time
+        const char* newline = findNewline(reader->data + reader->scan, end);
+
+        if (newline < end) {
+            line->data = start;
+            line->length = newline - start;
+            reader->pos += line->length + 1;
+            reader->scan = reader->pos;
+            return 1;
+        }
+        if (reader->eof) {
+            if (start == end) {
+                return 0;
+            }
+            line->data = start;  // Last line without a trailing '\n'
+            line->length = end - start;
+            reader->pos = reader->scan = reader->size;
+            return 1;
+        }
+        reader->scan = reader->size;
+        if (refillBlock(reader) != 0) {
+            return -1;
+        }
+    }
+}
+
+void lineReaderClose(LineReader* reader) {
+    if (reader->mapped) {
+        munmap(reader->data, reader->size);
+    } else {
+        free(reader->data);
+    }
+    close(reader->fd);
+    reader->data = NULL;
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Log-like lines of 20 to 219 characters, with an occasional 2000-character line
+static size_t writeTestFile(const char* path, size_t bytes) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return 0;
+    }
+    char line[2048];
+    size_t written = 0, lines = 0;
+    unsigned seed = 1;
+    while (written < bytes) {
+        seed = seed * 1103515245 + 12345;
+        size_t length = (lines % 1000 == 999) ? 2000 : 20 + (seed >> 16) % 200;
+        for (size_t i = 0; i < length; i++) {
+            line[i] = 'a' + (char)((i + lines) % 26);
+        }
+        line[length] = '\n';
+        fwrite(line, 1, length + 1, file);
+        written += length + 1;
+        lines++;
+    }
+    fclose(file);
+    return lines;
+}
+
+static void report(const char* name, size_t bytes, double seconds, size_t lines) {
+    printf("%-22s %8.2f GB/s %12zu lines\n", name, bytes / seconds / 1e9, lines);
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "lines_test.txt";
+    int created = argc <= 1;
+
+    size_t expected = 0;
+    if (created) {
+        expected = writeTestFile(path, TEST_FILE_SIZE);
+    }
+    struct stat sb;
+    if (stat(path, &sb) != 0) {
+        perror(path);
+        return 1;
+    }
+    size_t bytes = sb.st_size;
+    printf("%s: %.1f MiB", path, bytes / 1048576.0);
+    if (created) {
+        printf(", %zu lines", expected);
+    }
+    printf("\n");
+
+    // fgets() with a 100-byte buffer, as in example_fgets.c. Long lines come
+    // back in pieces, so it reports more "lines" than the file has.
+    FILE* file = fopen(path, "r");
+    char buffer[100];
+    size_t count = 0;
+    double start = nowSeconds();
+    while (fgets(buffer, sizeof(buffer), file) != NULL) {
+        count++;
+    }
+    report("fgets (100 bytes)", bytes, nowSeconds() - start, count);
+    fclose(file);
+
+    // getline() has no length limit but still copies every line
+    file = fopen(path, "r");
+    char* dynamic = NULL;
+    size_t dynamicSize = 0;
+    count = 0;
+    start = nowSeconds();
+    while (getline(&dynamic, &dynamicSize, file) != -1) {
+        count++;
+    }
+    report("getline", bytes, nowSeconds() - start, count);
+    free(dynamic);
+    fclose(file);
+
+    // Zero-copy views, first into 1 MiB blocks, then into the mapped file
+    size_t longest = 0;
+    for (int useMap = 0; useMap <= 1; useMap++) {
+        LineReader reader;
+        if (lineReaderOpen(&reader, path, useMap) != 0) {
+            perror(path);
+            return 1;
+        }
+        StringView line;
+        count = 0;
+        start = nowSeconds();
+        while (lineReaderNext(&reader, &line) == 1) {
+            count++;
+            if (line.length > longest) {
+                longest = line.length;
+            }
+        }
+        report(reader.mapped ? "line reader (mmap)" : "line reader (blocks)", bytes, nowSeconds() - start, count);
+        lineReaderClose(&reader);
+    }
+    printf("Longest line: %zu characters\n", longest);
+
+    if (created) {
+        remove(path);
+    }
+    return 0;
+}
\ No newline at end of file
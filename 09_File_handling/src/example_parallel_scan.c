@@ -0,0 +1,305 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define CACHE_LINE 64
+#define CHUNKS_PER_THREAD 8  // Extra chunks balance the load between threads
+#define MAX_THREADS 256
+
+typedef struct {
+    const char* data;
+    size_t size;
+} MappedFile;
+
+// Process one chunk of whole lines, adding the results to partial (one
+// partial per thread, so no locking is needed)
+typedef void (*ChunkFunc)(const char* data, size_t size, void* partial);
+// Add one thread's partial result to the total
+typedef void (*MergeFunc)(void* total, const void* partial);
+
+typedef struct {
+    ChunkFunc process;
+    MergeFunc merge;
+    size_t partialSize;  // Size of the result structure, zeroed before use
+} ScanJob;
+
+typedef struct {
+    const MappedFile* file;
+    const ScanJob* job;
+    const size_t* bounds;  // Chunk i is [bounds[i], bounds[i + 1])
+    int chunkCount;
+    _Atomic int nextChunk;
+} ScanShared;
+
+typedef struct {
+    ScanShared* shared;
+    void* partial;
+} ScanWorker;
+
+// Returns 0 on success, -1 on error (errno is set)
+int mappedFileOpen(MappedFile* file, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) == -1) {
+        close(fd);
+        return -1;
+    }
+    if (sb.st_size == 0) {
+        close(fd);
+        errno = EINVAL;  // mmap() cannot map zero bytes
+        return -1;
+    }
+    void* data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file open
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+    madvise(data, sb.st_size, MADV_SEQUENTIAL);  // Each chunk is read front to back
+    file->data = (const char*)data;
+    file->size = sb.st_size;
+    return 0;
+}
+
+void mappedFileClose(MappedFile* file) {
+    munmap((void*)file->data, file->size);
+}
+
+// Cut the file into about count chunks that end just after a '\n', so no
+// line is split between two threads. Returns the real number of chunks.
+static int splitLines(const MappedFile* file, int count, size_t* bounds) {
+    int chunks = 0;
+    bounds[0] = 0;
+    for (int i = 1; i < count; i++) {
+        size_t target = file->size / count * i;
+        if (target <= bounds[chunks]) {
+            continue;  // A long line already covers this chunk
+        }
+        const char* newline = (const char*)memchr(file->data + target, '\n', file->size - target);
+        if (newline == NULL) {
+            break;
+        }
+        bounds[++chunks] = newline - file->data + 1;
+    }
+    if (bounds[chunks] < file->size) {
+        bounds[++chunks] = file->size;
+    }
+    return chunks;
+}
+
+static void* scanWorker(void* arg) {
+    ScanWorker* worker = (ScanWorker*)arg;
+    ScanShared* shared = worker->shared;
+    for (;;) {
+        int chunk = atomic_fetch_add(&shared->nextChunk, 1);
+        if (chunk >= shared->chunkCount) {
+            break;
+        }
+        size_t start = shared->bounds[chunk];
+        shared->job->process(shared->file->data + start, shared->bounds[chunk + 1] - start, worker->partial);
+    }
+    return NULL;
+}
+
+// Run job over the whole file on threads threads and merge the partial
+// results into result (which must be zeroed). Returns 0 on success, -1 on error.
+int parallelScan(const MappedFile* file, int threads, const ScanJob* job, void* result) {
+    if (threads < 1 || threads > MAX_THREADS) {
+        return -1;
+    }
+    int wanted = threads * CHUNKS_PER_THREAD;
+    size_t* bounds = (size_t*)malloc((wanted + 1) * sizeof(size_t));
+    ScanWorker* workers = (ScanWorker*)malloc(threads * sizeof(ScanWorker));
+    pthread_t* tids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    // Partial results on separate cache lines, so threads don't slow each other down
+    size_t stride = (job->partialSize + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    char* partials = (char*)aligned_alloc(CACHE_LINE, stride * threads);
+    if (bounds == NULL || workers == NULL || tids == NULL || partials == NULL) {
+        free(bounds);
+        free(workers);
+        free(tids);
+        free(partials);
+        return -1;
+    }
+    memset(partials, 0, stride * threads);
+
+    ScanShared shared = {file, job, bounds, splitLines(file, wanted, bounds), 0};
+    int started = 0;
+    for (; started < threads; started++) {
+        workers[started].shared = &shared;
+        workers[started].partial = partials + stride * started;
+        if (started > 0 && pthread_create(&tids[started], NULL, scanWorker, &workers[started]) != 0) {
+            break;  // The threads that did start take over the remaining chunks
+        }
+    }
+    scanWorker(&workers[0]);  // The calling thread works too
+    for (int i = 1; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    // Merge in thread order, so the result does not depend on timing
+    for (int i = 0; i < started; i++) {
+        job->merge(result, workers[i].partial);
+    }
+
+    free(bounds);
+    free(workers);
+    free(tids);
+    free(partials);
+    return 0;
+}
+
+/* ---------- Example job: web server log statistics ---------- */
+
+// Lines look like "2024-05-01T12:00:00 INFO 200 123 /api/items"
+typedef struct {
+    long lines;
+    long errors;          // Level ERROR
+    long statusClass[6];  // 1xx .. 5xx, index 0 for anything else
+    long latencySum;
+    long latencyMax;
+} LogStats;
+
+static const char* parseNumber(const char* p, const char* end, long* value) {
+    long n = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        n = n * 10 + (*p++ - '0');
+    }
+    *value = n;
+    return p;
+}
+
+static void logChunk(const char* data, size_t size, void* partial) {
+    LogStats* stats = (LogStats*)partial;
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        stats->lines++;
+        const char* level = (const char*)memchr(p, ' ', lineEnd - p);
+        if (level != NULL) {
+            level++;
+            const char* field = (const char*)memchr(level, ' ', lineEnd - level);
+            if (field != NULL) {
+                stats->errors += field - level == 5 && memcmp(level, "ERROR", 5) == 0;
+                long status, latency;
+                field = parseNumber(field + 1, lineEnd, &status);
+                parseNumber(field + 1 < lineEnd ? field + 1 : lineEnd, lineEnd, &latency);
+                stats->statusClass[status >= 100 && status < 600 ? status / 100 : 0]++;
+                stats->latencySum += latency;
+                if (latency > stats->latencyMax) {
+                    stats->latencyMax = latency;
+                }
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+static void logMerge(void* total, const void* partial) {
+    LogStats* t = (LogStats*)total;
+    const LogStats* p = (const LogStats*)partial;
+    t->lines += p->lines;
+    t->errors += p->errors;
+    for (int i = 0; i < 6; i++) {
+        t->statusClass[i] += p->statusClass[i];
+    }
+    t->latencySum += p->latencySum;
+    if (p->latencyMax > t->latencyMax) {
+        t->latencyMax = p->latencyMax;
+    }
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void writeTestLog(const char* path, size_t bytes) {
+    static const char* levels[] = {"INFO", "INFO", "INFO", "WARN", "ERROR"};
+    static const int statuses[] = {200, 200, 200, 201, 304, 404, 500, 503};
+    FILE* file = fopen(path, "w");
+    size_t written = 0;
+    unsigned seed = 1;
+    for (long i = 0; written < bytes; i++) {
+        seed = seed * 1103515245 + 12345;
+        int n = fprintf(file, "2024-05-01T%02ld:%02ld:%02ld %s %d %u /api/items/%ld\n", i / 3600 % 24, i / 60 % 60,
+                        i % 60, levels[(seed >> 8) % 5], statuses[(seed >> 12) % 8], (seed >> 16) % 2000, i % 9973);
+        written += n;
+    }
+    fclose(file);
+}
+
+// 1, 2, 4, ... and finally maxThreads itself
+static int nextThreadCount(int threads, int maxThreads) {
+    return threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = "scan_test.log";
+    size_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 512;
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int maxThreads = argc > 2 ? atoi(argv[2]) : cpus;
+
+    writeTestLog(path, mib << 20);
+    MappedFile file;
+    if (mappedFileOpen(&file, path) != 0) {
+        perror(path);
+        return 1;
+    }
+    ScanJob job = {logChunk, logMerge, sizeof(LogStats)};
+
+    // Single-thread scan without the framework; the first run loads the page cache
+    LogStats single;
+    double singleTime = 0;
+    for (int run = 0; run < 2; run++) {
+        memset(&single, 0, sizeof(single));
+        double start = nowSeconds();
+        logChunk(file.data, file.size, &single);
+        singleTime = nowSeconds() - start;
+    }
+    printf("%s: %.1f MiB, %ld lines, %ld errors, %ld server errors, average latency %.1f ms\n", path,
+           file.size / 1048576.0, single.lines, single.errors, single.statusClass[5],
+           (double)single.latencySum / single.lines);
+    printf("%d CPUs online\n\n", cpus);
+
+    printf("%-18s %10s %10s %10s\n", "", "GB/s", "speedup", "result");
+    printf("%-18s %10.2f %10.2f %10s\n", "single thread", file.size / singleTime / 1e9, 1.0, "");
+    for (int threads = 1; threads <= maxThreads; threads = nextThreadCount(threads, maxThreads)) {
+        LogStats total;
+        memset(&total, 0, sizeof(total));
+        double start = nowSeconds();
+        if (parallelScan(&file, threads, &job, &total) != 0) {
+            printf("parallelScan failed\n");
+            break;
+        }
+        double elapsed = nowSeconds() - start;
+        char name[32];
+        snprintf(name, sizeof(name), "%d thread%s", threads, threads == 1 ? "" : "s");
+        printf("%-18s %10.2f %10.2f %10s\n", name, file.size / elapsed / 1e9, singleTime / elapsed,
+               memcmp(&total, &single, sizeof(total)) == 0 ? "same" : "DIFFERENT");
+    }
+    if (cpus < 2) {
+        printf("Only one CPU: the threads take turns, so the scan cannot get faster here.\n");
+    }
+
+    mappedFileClose(&file);
+    remove(path);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,373 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RECORD_MAGIC 0x46434552u  // "RECF" when read as little-endian bytes
+#define RECORD_VERSION 1
+#define RECORD_HEADER_SIZE 64
+#define RECORD_INDEXED 1          // Header flag: variable-length records with an offset index
+
+/*
+ * File layout (all integers little-endian):
+ *
+ *   offset 0   header, RECORD_HEADER_SIZE bytes
+ *              u32 magic, u16 version, u16 flags, u32 headerSize,
+ *              u32 recordSize (0 when indexed), u64 count,
+ *              u64 dataOffset, u64 indexOffset, rest reserved (zero)
+ *   dataOffset records, back to back
+ *   indexOffset (indexed files only) count + 1 u64 offsets; record i is
+ *              the bytes [offset[i], offset[i + 1]) of the file
+ *
+ * Readers reject versions newer than their own. New header fields that old
+ * readers can ignore keep the version and grow headerSize instead, since
+ * readers always skip to dataOffset.
+ */
+
+static void putLe16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void putLe32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void putLe64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+// On little-endian CPUs these compile to plain loads
+static uint16_t getLe16(const unsigned char* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t getLe32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t getLe64(const unsigned char* p) {
+    return (uint64_t)getLe32(p) | (uint64_t)getLe32(p + 4) << 32;
+}
+
+/* ---------- Writer ---------- */
+
+typedef struct {
+    FILE* file;
+    uint32_t recordSize;
+    uint64_t count;
+    uint64_t position;  // Current end of the data section
+    uint64_t* offsets;  // Indexed files: start of every record
+    size_t capacity;
+} RecordWriter;
+
+// recordSize 0 creates an indexed file of variable-length records
+int recordWriterOpen(RecordWriter* writer, const char* path, uint32_t recordSize) {
+    memset(writer, 0, sizeof(*writer));
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return -1;
+    }
+    writer->recordSize = recordSize;
+    writer->position = RECORD_HEADER_SIZE;
+    // Placeholder header, rewritten by recordWriterClose()
+    unsigned char header[RECORD_HEADER_SIZE] = {0};
+    return fwrite(header, 1, sizeof(header), writer->file) == sizeof(header) ? 0 : -1;
+}
+
+int recordWriterAppend(RecordWriter* writer, const void* data, size_t length) {
+    if (writer->recordSize != 0 && length != writer->recordSize) {
+        return -1;
+    }
+    if (writer->recordSize == 0) {
+        if (writer->count == writer->capacity) {
+            size_t capacity = writer->capacity ? writer->capacity * 2 : 1024;
+            uint64_t* offsets = (uint64_t*)realloc(writer->offsets, capacity * sizeof(uint64_t));
+            if (offsets == NULL) {
+                return -1;
+            }
+            writer->offsets = offsets;
+            writer->capacity = capacity;
+        }
+        writer->offsets[writer->count] = writer->position;
+    }
+    if (fwrite(data, 1, length, writer->file) != length) {
+        return -1;
+    }
+    writer->position += length;
+    writer->count++;
+    return 0;
+}
+
+// Writes the index and the final header. Returns 0 on success.
+int recordWriterClose(RecordWriter* writer) {
+    int result = 0;
+    uint64_t indexOffset = 0;
+    if (writer->recordSize == 0) {
+        indexOffset = writer->position;
+        unsigned char entry[8];
+        for (uint64_t i = 0; i <= writer->count; i++) {
+            putLe64(entry, i < writer->count ? writer->offsets[i] : writer->position);
+            if (fwrite(entry, 1, 8, writer->file) != 8) {
+                result = -1;
+            }
+        }
+    }
+
+    unsigned char header[RECORD_HEADER_SIZE] = {0};
+    putLe32(header, RECORD_MAGIC);
+    putLe16(header + 4, RECORD_VERSION);
+    putLe16(header + 6, writer->recordSize == 0 ? RECORD_INDEXED : 0);
+    putLe32(header + 8, RECORD_HEADER_SIZE);
+    putLe32(header + 12, writer->recordSize);
+    putLe64(header + 16, writer->count);
+    putLe64(header + 24, RECORD_HEADER_SIZE);
+    putLe64(header + 32, indexOffset);
+    if (fseek(writer->file, 0, SEEK_SET) != 0 || fwrite(header, 1, sizeof(header), writer->file) != sizeof(header)) {
+        result = -1;
+    }
+    if (fclose(writer->file) != 0) {
+        result = -1;
+    }
+    free(writer->offsets);
+    return result;
+}
+
+/* ---------- Reader ---------- */
+
+typedef struct {
+    const unsigned char* map;
+    size_t size;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t recordSize;
+    uint64_t count;
+    const unsigned char* records;
+    const unsigned char* index;
+} RecordFile;
+
+typedef enum {
+    RECORD_OK,
+    RECORD_IO_ERROR,
+    RECORD_BAD_MAGIC,
+    RECORD_BAD_VERSION,
+    RECORD_CORRUPT  // Sizes or offsets point outside the file
+} RecordStatus;
+
+RecordStatus recordFileOpen(RecordFile* rf, const char* path) {
+    memset(rf, 0, sizeof(*rf));
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return RECORD_IO_ERROR;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size < RECORD_HEADER_SIZE) {
+        close(fd);
+        return RECORD_CORRUPT;
+    }
+    void* map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping stays valid after close()
+    if (map == MAP_FAILED) {
+        return RECORD_IO_ERROR;
+    }
+    rf->map = (const unsigned char*)map;
+    rf->size = sb.st_size;
+
+    const unsigned char* h = rf->map;
+    RecordStatus status = RECORD_OK;
+    uint64_t dataOffset = getLe64(h + 24);
+    uint64_t indexOffset = getLe64(h + 32);
+    rf->version = getLe16(h + 4);
+    rf->flags = getLe16(h + 6);
+    rf->recordSize = getLe32(h + 12);
+    rf->count = getLe64(h + 16);
+
+    if (getLe32(h) != RECORD_MAGIC) {
+        status = RECORD_BAD_MAGIC;
+    } else if (rf->version == 0 || rf->version > RECORD_VERSION) {
+        status = RECORD_BAD_VERSION;
+    } else if (getLe32(h + 8) < RECORD_HEADER_SIZE || dataOffset > rf->size) {
+        status = RECORD_CORRUPT;
+    } else if (rf->flags & RECORD_INDEXED) {
+        // The index and every offset in it must lie inside the file
+        if (indexOffset > rf->size || rf->count >= (rf->size - indexOffset) / 8) {
+            status = RECORD_CORRUPT;
+        } else {
+            rf->index = rf->map + indexOffset;
+            uint64_t previous = dataOffset;
+            for (uint64_t i = 0; i <= rf->count && status == RECORD_OK; i++) {
+                uint64_t offset = getLe64(rf->index + 8 * i);
+                if (offset < previous || offset > indexOffset) {
+                    status = RECORD_CORRUPT;
+                }
+                previous = offset;
+            }
+        }
+    } else if (rf->recordSize == 0 || (rf->size - dataOffset) / rf->recordSize < rf->count) {
+        status = RECORD_CORRUPT;
+    }
+
+    if (status != RECORD_OK) {
+        munmap(map, rf->size);
+        rf->map = NULL;
+        return status;
+    }
+    rf->records = rf->map + dataOffset;
+    return RECORD_OK;
+}
+
+// O(1) pointer to record i inside the mapping; nothing is copied.
+// Returns NULL when i is out of range.
+static inline const void* recordFileGet(const RecordFile* rf, uint64_t i, size_t* length) {
+    if (i >= rf->count) {
+        return NULL;
+    }
+    if (rf->index == NULL) {
+        *length = rf->recordSize;
+        return rf->records + i * rf->recordSize;
+    }
+    uint64_t start = getLe64(rf->index + 8 * i);
+    *length = getLe64(rf->index + 8 * (i + 1)) - start;
+    return rf->map + start;
+}
+
+void recordFileClose(RecordFile* rf) {
+    if (rf->map != NULL) {
+        munmap((void*)rf->map, rf->size);
+        rf->map = NULL;
+    }
+}
+
+/* ---------- Fixed-width Person records ---------- */
+
+// On-disk layout of one person: 64 bytes, independent of the compiler
+#define PERSON_SIZE 64
+#define PERSON_NAME 56
+
+struct Person {
+    char name[50];
+    int age;
+};
+
+static void encodePerson(unsigned char* out, const struct Person* person, uint32_t id) {
+    memset(out, 0, PERSON_SIZE);
+    putLe32(out, id);
+    putLe32(out + 4, (uint32_t)person->age);
+    strncpy((char*)out + 8, person->name, PERSON_NAME - 1);
+}
+
+static int personAge(const unsigned char* record) {
+    return (int32_t)getLe32(record + 4);
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    long n = argc > 1 ? atol(argv[1]) : 1000000;
+    long lookups = 1000000;
+    const char* rawPath = "people_raw.bin";
+    const char* recordPath = "people.rec";
+    const char* textPath = "names.rec";
+
+    // Variable-length records with an index
+    RecordWriter writer;
+    const char* names[] = {"Al", "John Doe", "Maria Fernanda Gonzalez", "Li"};
+    recordWriterOpen(&writer, textPath, 0);
+    for (int i = 0; i < 4; i++) {
+        recordWriterAppend(&writer, names[i], strlen(names[i]));
+    }
+    recordWriterClose(&writer);
+
+    RecordFile rf;
+    RecordStatus status = recordFileOpen(&rf, textPath);
+    if (status != RECORD_OK) {
+        printf("Error %d opening %s\n", status, textPath);
+        return 1;
+    }
+    size_t length = 0;
+    const char* name = (const char*)recordFileGet(&rf, 2, &length);
+    printf("Version %u, %llu records, record 2 = \"%.*s\"\n", rf.version, (unsigned long long)rf.count, (int)length,
+           name);
+    recordFileClose(&rf);
+    remove(textPath);
+
+    // The same people as raw structs (example_binary_file_io.c) and as records
+    FILE* raw = fopen(rawPath, "wb");
+    recordWriterOpen(&writer, recordPath, PERSON_SIZE);
+    for (long i = 0; i < n; i++) {
+        struct Person person;
+        snprintf(person.name, sizeof(person.name), "Person %ld", i);
+        person.age = (int)(i % 100);
+        fwrite(&person, sizeof(person), 1, raw);
+
+        unsigned char record[PERSON_SIZE];
+        encodePerson(record, &person, (uint32_t)i);
+        recordWriterAppend(&writer, record, PERSON_SIZE);
+    }
+    fclose(raw);
+    recordWriterClose(&writer);
+
+    long* order = (long*)malloc(lookups * sizeof(long));
+    srand(1);
+    for (long i = 0; i < lookups; i++) {
+        order[i] = ((long)rand() * RAND_MAX + rand()) % n;
+    }
+
+    // fread: sequential, then fseek + fread per random record
+    long sumRaw = 0;
+    raw = fopen(rawPath, "rb");
+    struct Person person;
+    double start = nowSeconds();
+    while (fread(&person, sizeof(person), 1, raw) == 1) {
+        sumRaw += person.age;
+    }
+    double rawSeq = nowSeconds() - start;
+    start = nowSeconds();
+    for (long i = 0; i < lookups; i++) {
+        fseek(raw, order[i] * (long)sizeof(person), SEEK_SET);
+        if (fread(&person, sizeof(person), 1, raw) == 1) {
+            sumRaw += person.age;
+        }
+    }
+    double rawRand = nowSeconds() - start;
+    fclose(raw);
+
+    // mmap record file
+    long sumRec = 0;
+    if ((status = recordFileOpen(&rf, recordPath)) != RECORD_OK) {
+        printf("Error %d opening %s\n", status, recordPath);
+        return 1;
+    }
+    start = nowSeconds();
+    for (uint64_t i = 0; i < rf.count; i++) {
+        sumRec += personAge((const unsigned char*)recordFileGet(&rf, i, &length));
+    }
+    double recSeq = nowSeconds() - start;
+    start = nowSeconds();
+    for (long i = 0; i < lookups; i++) {
+        sumRec += personAge((const unsigned char*)recordFileGet(&rf, order[i], &length));
+    }
+    double recRand = nowSeconds() - start;
+    recordFileClose(&rf);
+
+    printf("\n%ld people, million records/s\n", n);
+    printf("%-16s %12s %12s\n", "", "sequential", "random");
+    printf("%-16s %12.1f %12.1f\n", "fread", n / rawSeq / 1e6, lookups / rawRand / 1e6);
+    printf("%-16s %12.1f %12.1f\n", "mmap records", n / recSeq / 1e6, lookups / recRand / 1e6);
+    printf("Results match: %s\n", sumRaw == sumRec ? "yes" : "no");
+
+    free(order);
+    remove(rawPath);
+    remove(recordPath);
+    return 0;
+}
\ No newline at end of file
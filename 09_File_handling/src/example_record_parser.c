@@ -0,0 +1,269 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define MAX_STR 50
+
+typedef struct {
+    int num;
+    char str[MAX_STR];
+} Record;
+
+typedef enum {
+    PARSE_OK,
+    PARSE_END,         // No more records
+    PARSE_BAD_NUMBER,  // The first field is not an integer
+    PARSE_OVERFLOW,    // The number does not fit in an int
+    PARSE_TOO_LONG,    // The string does not fit in Record.str
+    PARSE_MISSING      // The line ends after the number
+} ParseStatus;
+
+// Parses "<int> <word>" records from a buffer that is already in memory
+typedef struct {
+    const char* p;
+    const char* end;
+    size_t line;
+} RecordParser;
+
+void parserInit(RecordParser* parser, const char* data, size_t size) {
+    parser->p = data;
+    parser->end = data + size;
+    parser->line = 1;
+}
+
+static inline int isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void skipSpace(RecordParser* parser) {
+    while (parser->p < parser->end && isSpace(*parser->p)) {
+        parser->line += *parser->p == '\n';
+        parser->p++;
+    }
+}
+
+// Number of leading ASCII digits in the 8 bytes of chunk (first byte lowest)
+static inline int countDigits(uint64_t chunk) {
+    uint64_t value = chunk - 0x3030303030303030ULL;  // '0' -> 0 in every byte
+    // A byte's top bit ends up set if it was below '0' or above '9'
+    uint64_t nonDigit = (value | (value + 0x7676767676767676ULL)) & 0x8080808080808080ULL;
+    return nonDigit ? __builtin_ctzll(nonDigit) / 8 : 8;
+}
+
+// Convert 8 digit bytes to a number with three multiplications (SWAR)
+static inline uint32_t parseEightDigits(uint64_t chunk) {
+    uint64_t value = chunk - 0x3030303030303030ULL;
+    value = (value * 10) + (value >> 8);  // Pairs of digits
+    value = (((value & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((value >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)value;
+}
+
+static ParseStatus parseInt(RecordParser* parser, int* out) {
+    const char* p = parser->p;
+    int negative = 0;
+    if (p < parser->end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t value = 0;
+    int digits = 0, done = 0;
+    if (parser->end - p >= 8) {
+        // Fast path: up to 8 digits from one 64-bit load
+        uint64_t chunk;
+        memcpy(&chunk, p, 8);
+        digits = countDigits(chunk);
+        if (digits > 0) {
+            // Move the digits to the top bytes and fill the bottom with '0's
+            int pad = 8 * (8 - digits);
+            uint64_t aligned = digits == 8 ? chunk : (chunk << pad) | (0x3030303030303030ULL >> (64 - pad));
+            value = parseEightDigits(aligned);
+            p += digits;
+        }
+        done = digits < 8;
+    }
+    if (!done) {
+        // Numbers longer than 8 digits, or too close to the end of the buffer
+        while (p < parser->end && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            p++;
+            if (++digits > 10) {
+                return PARSE_OVERFLOW;
+            }
+        }
+    }
+    if (digits == 0) {
+        return PARSE_BAD_NUMBER;
+    }
+    if (value > (uint64_t)INT_MAX + negative) {
+        return PARSE_OVERFLOW;
+    }
+    *out = negative ? (int)(0 - value) : (int)value;
+    parser->p = p;
+    return PARSE_OK;
+}
+
+// Length of the run of non-whitespace bytes at p
+static size_t tokenLength(const char* p, const char* end) {
+    const char* start = p;
+#ifdef __AVX2__
+    // Bytes above ' ' are token characters: max(c, '!') == c
+    const __m256i limit = _mm256_set1_epi8('!');
+    for (; p + 32 <= end; p += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        unsigned token = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, limit), chunk));
+        if (token != 0xFFFFFFFFu) {
+            return p - start + __builtin_ctz(~token);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i limit = _mm_set1_epi8('!');
+    for (; p + 16 <= end; p += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        unsigned token = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, limit), chunk));
+        if (token != 0xFFFFu) {
+            return p - start + __builtin_ctz(~token);
+        }
+    }
+#endif
+    while (p < end && (unsigned char)*p > ' ') {
+        p++;
+    }
+    return p - start;
+}
+
+// Equivalent to fscanf(file, "%d %49s", ...), but a string that does not fit
+// is reported instead of overflowing or being split
+ParseStatus parseRecord(RecordParser* parser, Record* record) {
+    skipSpace(parser);
+    if (parser->p >= parser->end) {
+        return PARSE_END;
+    }
+    ParseStatus status = parseInt(parser, &record->num);
+    if (status != PARSE_OK) {
+        return status;
+    }
+
+    while (parser->p < parser->end && (*parser->p == ' ' || *parser->p == '\t')) {
+        parser->p++;
+    }
+    size_t length = tokenLength(parser->p, parser->end);
+    if (length == 0) {
+        return PARSE_MISSING;
+    }
+    if (length >= MAX_STR) {
+        return PARSE_TOO_LONG;
+    }
+    memcpy(record->str, parser->p, length);
+    record->str[length] = '\0';
+    parser->p += length;
+    return PARSE_OK;
+}
+
+/* ---------- Benchmark ---------- */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void writeTestFile(const char* path, long records) {
+    FILE* file = fopen(path, "w");
+    unsigned seed = 1;
+    for (long i = 0; i < records; i++) {
+        seed = seed * 1103515245 + 12345;
+        int digits = 1 + (seed >> 16) % 10;
+        long num = (seed >> 8) % 1000000000L;
+        for (int d = 10; d > digits; d--) {
+            num /= 10;
+        }
+        if (seed & 1) {
+            num = -num;
+        }
+        char word[16];
+        int length = 3 + (seed >> 20) % 10;
+        for (int c = 0; c < length; c++) {
+            word[c] = 'a' + (char)((i + c * 7) % 26);
+        }
+        word[length] = '\0';
+        fprintf(file, "%ld %s\n", num, word);
+    }
+    fclose(file);
+}
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? atol(argv[1]) : 5000000;
+    const char* path = "records_test.txt";
+
+    // Error reporting on a few malformed records
+    const char* bad = "42 ok\n"
+                      "x12 letters\n";
+    RecordParser parser;
+    Record record;
+    parserInit(&parser, bad, strlen(bad));
+    ParseStatus status = parseRecord(&parser, &record);
+    printf("Record: %d %s (status %d)\n", record.num, record.str, status);
+    status = parseRecord(&parser, &record);
+    printf("Line %zu: status %d (bad number)\n", parser.line, status);
+
+    const char* overflow = "99999999999 big";
+    parserInit(&parser, overflow, strlen(overflow));
+    printf("\"%s\": status %d (overflow)\n", overflow, parseRecord(&parser, &record));
+
+    writeTestFile(path, records);
+
+    // fscanf, as in example_fscanf.c (with a field width to stay in bounds)
+    FILE* file = fopen(path, "r");
+    long count = 0, sum = 0;
+    int num;
+    char str[MAX_STR];
+    double start = nowSeconds();
+    while (fscanf(file, "%d %49s", &num, str) == 2) {
+        count++;
+        sum += num + str[0];
+    }
+    double scanTime = nowSeconds() - start;
+    fclose(file);
+
+    // The parser works on the whole file loaded into memory
+    file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char* data = (char*)malloc(size);
+    if (data == NULL || fread(data, 1, size, file) != (size_t)size) {
+        fprintf(stderr, "Could not load %s\n", path);
+        return 1;
+    }
+    fclose(file);
+
+    long count2 = 0, sum2 = 0;
+    start = nowSeconds();
+    parserInit(&parser, data, size);
+    while ((status = parseRecord(&parser, &record)) == PARSE_OK) {
+        count2++;
+        sum2 += record.num + record.str[0];
+    }
+    double parseTime = nowSeconds() - start;
+    if (status != PARSE_END) {
+        printf("Parse error %d on line %zu\n", status, parser.line);
+    }
+
+    printf("\n%ld records, %.1f MiB\n", records, size / 1048576.0);
+    printf("fscanf: %8.2f M records/s\n", count / scanTime / 1e6);
+    printf("parser: %8.2f M records/s (%.2f GB/s)\n", count2 / parseTime / 1e6, size / parseTime / 1e9);
+    printf("Results match: %s\n", count == count2 && sum == sum2 ? "yes" : "no");
+
+    free(data);
+    remove(path);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,798 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define MAX_PREFIX 10
+
+enum { NODE4 = 1, NODE16, NODE48, NODE256 };
+
+// Header shared by all inner nodes. Up to MAX_PREFIX bytes of the compressed
+// path are stored inline; longer prefixes are checked against a leaf.
+typedef struct {
+    uint8_t type;
+    uint16_t numChildren;
+    uint32_t prefixLen;
+    unsigned char prefix[MAX_PREFIX];
+} ArtNode;
+
+typedef struct {
+    ArtNode n;
+    unsigned char keys[4];
+    ArtNode* children[4];
+} ArtNode4;
+
+typedef struct {
+    ArtNode n;
+    unsigned char keys[16];
+    ArtNode* children[16];
+} ArtNode16;
+
+typedef struct {
+    ArtNode n;
+    unsigned char childIndex[256];  // 0 = empty, otherwise slot + 1
+    ArtNode* children[48];
+} ArtNode48;
+
+typedef struct {
+    ArtNode n;
+    ArtNode* children[256];
+} ArtNode256;
+
+// Leaves hold the full key (including the terminating '\0', so that no key
+// is a prefix of another) and are tagged by setting the lowest pointer bit.
+typedef struct {
+    int value;
+    uint32_t keyLen;
+    unsigned char key[];
+} ArtLeaf;
+
+typedef struct {
+    ArtNode* root;
+    size_t size;
+} ArtTree;
+
+typedef int (*ArtCallback)(void* data, const unsigned char* key, uint32_t keyLen, int value);
+
+#define IS_LEAF(x) (((uintptr_t)(x)) & 1)
+#define SET_LEAF(x) ((ArtNode*)((uintptr_t)(x) | 1))
+#define LEAF_RAW(x) ((ArtLeaf*)((uintptr_t)(x) & ~(uintptr_t)1))
+
+static uint32_t minU32(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+static ArtNode* allocNode(uint8_t type) {
+    static const size_t sizes[] = {0, sizeof(ArtNode4), sizeof(ArtNode16),
+                                   sizeof(ArtNode48), sizeof(ArtNode256)};
+    ArtNode* n = (ArtNode*)calloc(1, sizes[type]);
+    n->type = type;
+    return n;
+}
+
+static ArtLeaf* makeLeaf(const unsigned char* key, uint32_t keyLen, int value) {
+    ArtLeaf* l = (ArtLeaf*)malloc(sizeof(ArtLeaf) + keyLen);
+    l->value = value;
+    l->keyLen = keyLen;
+    memcpy(l->key, key, keyLen);
+    return l;
+}
+
+static void destroyNode(ArtNode* n) {
+    if (n == NULL) {
+        return;
+    }
+    if (IS_LEAF(n)) {
+        free(LEAF_RAW(n));
+        return;
+    }
+
+    switch (n->type) {
+    case NODE4:
+        for (int i = 0; i < n->numChildren; i++) destroyNode(((ArtNode4*)n)->children[i]);
+        break;
+    case NODE16:
+        for (int i = 0; i < n->numChildren; i++) destroyNode(((ArtNode16*)n)->children[i]);
+        break;
+    case NODE48:
+        for (int i = 0; i < 48; i++) destroyNode(((ArtNode48*)n)->children[i]);
+        break;
+    case NODE256:
+        for (int i = 0; i < 256; i++) destroyNode(((ArtNode256*)n)->children[i]);
+        break;
+    }
+    free(n);
+}
+
+void artInit(ArtTree* t) {
+    t->root = NULL;
+    t->size = 0;
+}
+
+void artDestroy(ArtTree* t) {
+    destroyNode(t->root);
+    artInit(t);
+}
+
+static ArtNode** findChild(ArtNode* n, unsigned char c) {
+    switch (n->type) {
+    case NODE4: {
+        ArtNode4* p = (ArtNode4*)n;
+        for (int i = 0; i < n->numChildren; i++) {
+            if (p->keys[i] == c) return &p->children[i];
+        }
+        break;
+    }
+    case NODE16: {
+        ArtNode16* p = (ArtNode16*)n;
+#ifdef __SSE2__
+        // Compare the search byte with all 16 keys at once
+        __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)p->keys));
+        unsigned mask = _mm_movemask_epi8(cmp) & ((1u << n->numChildren) - 1);
+        if (mask) return &p->children[__builtin_ctz(mask)];
+#else
+        for (int i = 0; i < n->numChildren; i++) {
+            if (p->keys[i] == c) return &p->children[i];
+        }
+#endif
+        break;
+    }
+    case NODE48: {
+        ArtNode48* p = (ArtNode48*)n;
+        if (p->childIndex[c]) return &p->children[p->childIndex[c] - 1];
+        break;
+    }
+    case NODE256: {
+        ArtNode256* p = (ArtNode256*)n;
+        if (p->children[c]) return &p->children[c];
+        break;
+    }
+    }
+    return NULL;
+}
+
+// Number of stored prefix bytes that match the key (optimistic check)
+static uint32_t checkPrefix(const ArtNode* n, const unsigned char* key, uint32_t keyLen, uint32_t depth) {
+    uint32_t maxCmp = minU32(minU32(n->prefixLen, MAX_PREFIX), keyLen - depth);
+    uint32_t i;
+    for (i = 0; i < maxCmp; i++) {
+        if (n->prefix[i] != key[depth + i]) break;
+    }
+    return i;
+}
+
+static ArtLeaf* minimumLeaf(const ArtNode* n) {
+    while (n != NULL && !IS_LEAF(n)) {
+        switch (n->type) {
+        case NODE4: n = ((const ArtNode4*)n)->children[0]; break;
+        case NODE16: n = ((const ArtNode16*)n)->children[0]; break;
+        case NODE48: {
+            const ArtNode48* p = (const ArtNode48*)n;
+            int i = 0;
+            while (!p->childIndex[i]) i++;
+            n = p->children[p->childIndex[i] - 1];
+            break;
+        }
+        case NODE256: {
+            const ArtNode256* p = (const ArtNode256*)n;
+            int i = 0;
+            while (!p->children[i]) i++;
+            n = p->children[i];
+            break;
+        }
+        }
+    }
+    return n ? LEAF_RAW(n) : NULL;
+}
+
+// Exact number of matching prefix bytes, consulting a leaf past MAX_PREFIX
+static uint32_t prefixMismatch(const ArtNode* n, const unsigned char* key, uint32_t keyLen, uint32_t depth) {
+    uint32_t maxCmp = minU32(minU32(MAX_PREFIX, n->prefixLen), keyLen - depth);
+    uint32_t i;
+    for (i = 0; i < maxCmp; i++) {
+        if (n->prefix[i] != key[depth + i]) return i;
+    }
+
+    if (n->prefixLen > MAX_PREFIX) {
+        const ArtLeaf* l = minimumLeaf(n);
+        maxCmp = minU32(minU32(l->keyLen, keyLen) - depth, n->prefixLen);
+        for (; i < maxCmp; i++) {
+            if (l->key[depth + i] != key[depth + i]) return i;
+        }
+    }
+    return i;
+}
+
+static int leafMatches(const ArtLeaf* l, const unsigned char* key, uint32_t keyLen) {
+    return l->keyLen == keyLen && memcmp(l->key, key, keyLen) == 0;
+}
+
+// Returns 1 and stores the value in *value if key is present, 0 otherwise
+int artSearch(const ArtTree* t, const char* str, int* value) {
+    const unsigned char* key = (const unsigned char*)str;
+    uint32_t keyLen = strlen(str) + 1;
+    ArtNode* n = t->root;
+    uint32_t depth = 0;
+
+    while (n != NULL) {
+        if (IS_LEAF(n)) {
+            ArtLeaf* l = LEAF_RAW(n);
+            if (!leafMatches(l, key, keyLen)) {
+                return 0;
+            }
+            *value = l->value;
+            return 1;
+        }
+        if (n->prefixLen) {
+            if (checkPrefix(n, key, keyLen, depth) != minU32(MAX_PREFIX, n->prefixLen)) {
+                return 0;
+            }
+            depth += n->prefixLen;
+        }
+        if (depth >= keyLen) {
+            return 0;
+        }
+        ArtNode** child = findChild(n, key[depth]);
+        n = child ? *child : NULL;
+        depth++;
+    }
+    return 0;
+}
+
+static void copyHeader(ArtNode* dest, const ArtNode* src) {
+    dest->numChildren = src->numChildren;
+    dest->prefixLen = src->prefixLen;
+    memcpy(dest->prefix, src->prefix, minU32(MAX_PREFIX, src->prefixLen));
+}
+
+static void addChild(ArtNode* n, ArtNode** ref, unsigned char c, ArtNode* child);
+
+static void addChild256(ArtNode256* n, unsigned char c, ArtNode* child) {
+    n->n.numChildren++;
+    n->children[c] = child;
+}
+
+static void addChild48(ArtNode48* n, ArtNode** ref, unsigned char c, ArtNode* child) {
+    if (n->n.numChildren < 48) {
+        int pos = 0;
+        while (n->children[pos]) pos++;
+        n->children[pos] = child;
+        n->childIndex[c] = pos + 1;
+        n->n.numChildren++;
+    } else {
+        ArtNode256* bigger = (ArtNode256*)allocNode(NODE256);
+        for (int i = 0; i < 256; i++) {
+            if (n->childIndex[i]) bigger->children[i] = n->children[n->childIndex[i] - 1];
+        }
+        copyHeader(&bigger->n, &n->n);
+        *ref = (ArtNode*)bigger;
+        free(n);
+        addChild256(bigger, c, child);
+    }
+}
+
+static void addChild16(ArtNode16* n, ArtNode** ref, unsigned char c, ArtNode* child) {
+    if (n->n.numChildren < 16) {
+        int pos = 0;
+        while (pos < n->n.numChildren && n->keys[pos] < c) pos++;
+        memmove(n->keys + pos + 1, n->keys + pos, n->n.numChildren - pos);
+        memmove(n->children + pos + 1, n->children + pos, (n->n.numChildren - pos) * sizeof(ArtNode*));
+        n->keys[pos] = c;
+        n->children[pos] = child;
+        n->n.numChildren++;
+    } else {
+        ArtNode48* bigger = (ArtNode48*)allocNode(NODE48);
+        memcpy(bigger->children, n->children, 16 * sizeof(ArtNode*));
+        for (int i = 0; i < 16; i++) {
+            bigger->childIndex[n->keys[i]] = i + 1;
+        }
+        copyHeader(&bigger->n, &n->n);
+        *ref = (ArtNode*)bigger;
+        free(n);
+        addChild48(bigger, ref, c, child);
+    }
+}
+
+static void addChild4(ArtNode4* n, ArtNode** ref, unsigned char c, ArtNode* child) {
+    if (n->n.numChildren < 4) {
+        int pos = 0;
+        while (pos < n->n.numChildren && n->keys[pos] < c) pos++;
+        memmove(n->keys + pos + 1, n->keys + pos, n->n.numChildren - pos);
+        memmove(n->children + pos + 1, n->children + pos, (n->n.numChildren - pos) * sizeof(ArtNode*));
+        n->keys[pos] = c;
+        n->children[pos] = child;
+        n->n.numChildren++;
+    } else {
+        ArtNode16* bigger = (ArtNode16*)allocNode(NODE16);
+        memcpy(bigger->children, n->children, 4 * sizeof(ArtNode*));
+        memcpy(bigger->keys, n->keys, 4);
+        copyHeader(&bigger->n, &n->n);
+        *ref = (ArtNode*)bigger;
+        free(n);
+        addChild16(bigger, ref, c, child);
+    }
+}
+
+static void addChild(ArtNode* n, ArtNode** ref, unsigned char c, ArtNode* child) {
+    switch (n->type) {
+    case NODE4: addChild4((ArtNode4*)n, ref, c, child); break;
+    case NODE16: addChild16((ArtNode16*)n, ref, c, child); break;
+    case NODE48: addChild48((ArtNode48*)n, ref, c, child); break;
+    case NODE256: addChild256((ArtNode256*)n, c, child); break;
+    }
+}
+
+static int insertRec(ArtNode* n, ArtNode** ref, const unsigned char* key, uint32_t keyLen,
+                     int value, uint32_t depth) {
+    if (n == NULL) {
+        *ref = SET_LEAF(makeLeaf(key, keyLen, value));
+        return 1;
+    }
+
+    if (IS_LEAF(n)) {
+        ArtLeaf* l = LEAF_RAW(n);
+        if (leafMatches(l, key, keyLen)) {
+            l->value = value;
+            return 0;
+        }
+
+        // Split the leaf into a Node4 holding the common part of both keys
+        ArtNode4* split = (ArtNode4*)allocNode(NODE4);
+        uint32_t common = 0;
+        uint32_t maxCmp = minU32(l->keyLen, keyLen) - depth;
+        while (common < maxCmp && l->key[depth + common] == key[depth + common]) common++;
+
+        split->n.prefixLen = common;
+        memcpy(split->n.prefix, key + depth, minU32(MAX_PREFIX, common));
+        *ref = (ArtNode*)split;
+        addChild4(split, ref, l->key[depth + common], n);
+        addChild4(split, ref, key[depth + common], SET_LEAF(makeLeaf(key, keyLen, value)));
+        return 1;
+    }
+
+    if (n->prefixLen) {
+        uint32_t diff = prefixMismatch(n, key, keyLen, depth);
+        if (diff < n->prefixLen) {
+            // The key leaves the compressed path: split the prefix at diff
+            ArtNode4* split = (ArtNode4*)allocNode(NODE4);
+            *ref = (ArtNode*)split;
+            split->n.prefixLen = diff;
+            memcpy(split->n.prefix, n->prefix, minU32(MAX_PREFIX, diff));
+
+            if (n->prefixLen <= MAX_PREFIX) {
+                addChild4(split, ref, n->prefix[diff], n);
+                n->prefixLen -= diff + 1;
+                memmove(n->prefix, n->prefix + diff + 1, minU32(MAX_PREFIX, n->prefixLen));
+            } else {
+                n->prefixLen -= diff + 1;
+                const ArtLeaf* l = minimumLeaf(n);
+                addChild4(split, ref, l->key[depth + diff], n);
+                memcpy(n->prefix, l->key + depth + diff + 1, minU32(MAX_PREFIX, n->prefixLen));
+            }
+            addChild4(split, ref, key[depth + diff], SET_LEAF(makeLeaf(key, keyLen, value)));
+            return 1;
+        }
+        depth += n->prefixLen;
+    }
+
+    ArtNode** child = findChild(n, key[depth]);
+    if (child) {
+        return insertRec(*child, child, key, keyLen, value, depth + 1);
+    }
+    addChild(n, ref, key[depth], SET_LEAF(makeLeaf(key, keyLen, value)));
+    return 1;
+}
+
+void artInsert(ArtTree* t, const char* key, int value) {
+    if (insertRec(t->root, &t->root, (const unsigned char*)key, strlen(key) + 1, value, 0)) {
+        t->size++;
+    }
+}
+
+static void removeChild256(ArtNode256* n, ArtNode** ref, unsigned char c) {
+    n->children[c] = NULL;
+    n->n.numChildren--;
+
+    // Shrink with some hysteresis so alternating insert/delete does not thrash
+    if (n->n.numChildren == 37) {
+        ArtNode48* smaller = (ArtNode48*)allocNode(NODE48);
+        copyHeader(&smaller->n, &n->n);
+        int pos = 0;
+        for (int i = 0; i < 256; i++) {
+            if (n->children[i]) {
+                smaller->children[pos] = n->children[i];
+                smaller->childIndex[i] = ++pos;
+            }
+        }
+        *ref = (ArtNode*)smaller;
+        free(n);
+    }
+}
+
+static void removeChild48(ArtNode48* n, ArtNode** ref, unsigned char c) {
+    int pos = n->childIndex[c] - 1;
+    n->childIndex[c] = 0;
+    n->children[pos] = NULL;
+    n->n.numChildren--;
+
+    if (n->n.numChildren == 12) {
+        ArtNode16* smaller = (ArtNode16*)allocNode(NODE16);
+        copyHeader(&smaller->n, &n->n);
+        int child = 0;
+        for (int i = 0; i < 256; i++) {
+            if (n->childIndex[i]) {
+                smaller->keys[child] = i;
+                smaller->children[child++] = n->children[n->childIndex[i] - 1];
+            }
+        }
+        *ref = (ArtNode*)smaller;
+        free(n);
+    }
+}
+
+static void removeChild16(ArtNode16* n, ArtNode** ref, ArtNode** slot) {
+    int pos = slot - n->children;
+    memmove(n->keys + pos, n->keys + pos + 1, n->n.numChildren - 1 - pos);
+    memmove(n->children + pos, n->children + pos + 1, (n->n.numChildren - 1 - pos) * sizeof(ArtNode*));
+    n->n.numChildren--;
+
+    if (n->n.numChildren == 3) {
+        ArtNode4* smaller = (ArtNode4*)allocNode(NODE4);
+        copyHeader(&smaller->n, &n->n);
+        memcpy(smaller->keys, n->keys, 3);
+        memcpy(smaller->children, n->children, 3 * sizeof(ArtNode*));
+        *ref = (ArtNode*)smaller;
+        free(n);
+    }
+}
+
+static void removeChild4(ArtNode4* n, ArtNode** ref, ArtNode** slot) {
+    int pos = slot - n->children;
+    memmove(n->keys + pos, n->keys + pos + 1, n->n.numChildren - 1 - pos);
+    memmove(n->children + pos, n->children + pos + 1, (n->n.numChildren - 1 - pos) * sizeof(ArtNode*));
+    n->n.numChildren--;
+
+    // A Node4 with a single child is merged into that child
+    if (n->n.numChildren == 1) {
+        ArtNode* child = n->children[0];
+        if (!IS_LEAF(child)) {
+            uint32_t prefix = n->n.prefixLen;
+            if (prefix < MAX_PREFIX) {
+                n->n.prefix[prefix++] = n->keys[0];
+            }
+            if (prefix < MAX_PREFIX) {
+                uint32_t sub = minU32(child->prefixLen, MAX_PREFIX - prefix);
+                memcpy(n->n.prefix + prefix, child->prefix, sub);
+                prefix += sub;
+            }
+            memcpy(child->prefix, n->n.prefix, minU32(prefix, MAX_PREFIX));
+            child->prefixLen += n->n.prefixLen + 1;
+        }
+        *ref = child;
+        free(n);
+    }
+}
+
+static void removeChild(ArtNode* n, ArtNode** ref, unsigned char c, ArtNode** slot) {
+    switch (n->type) {
+    case NODE4: removeChild4((ArtNode4*)n, ref, slot); break;
+    case NODE16: removeChild16((ArtNode16*)n, ref, slot); break;
+    case NODE48: removeChild48((ArtNode48*)n, ref, c); break;
+    case NODE256: removeChild256((ArtNode256*)n, ref, c); break;
+    }
+}
+
+static ArtLeaf* deleteRec(ArtNode* n, ArtNode** ref, const unsigned char* key, uint32_t keyLen, uint32_t depth) {
+    if (n == NULL) {
+        return NULL;
+    }
+    if (IS_LEAF(n)) {
+        ArtLeaf* l = LEAF_RAW(n);
+        if (leafMatches(l, key, keyLen)) {
+            *ref = NULL;
+            return l;
+        }
+        return NULL;
+    }
+
+    if (n->prefixLen) {
+        if (checkPrefix(n, key, keyLen, depth) != minU32(MAX_PREFIX, n->prefixLen)) {
+            return NULL;
+        }
+        depth += n->prefixLen;
+    }
+    if (depth >= keyLen) {
+        return NULL;
+    }
+
+    ArtNode** child = findChild(n, key[depth]);
+    if (child == NULL) {
+        return NULL;
+    }
+    if (IS_LEAF(*child)) {
+        ArtLeaf* l = LEAF_RAW(*child);
+        if (leafMatches(l, key, keyLen)) {
+            removeChild(n, ref, key[depth], child);
+            return l;
+        }
+        return NULL;
+    }
+    return deleteRec(*child, child, key, keyLen, depth + 1);
+}
+
+// Returns 1 if key was removed (storing its value in *value unless value is
+// NULL), 0 if it was not present
+int artDelete(ArtTree* t, const char* key, int* value) {
+    ArtLeaf* l = deleteRec(t->root, &t->root, (const unsigned char*)key, strlen(key) + 1, 0);
+    if (l == NULL) {
+        return 0;
+    }
+    if (value != NULL) {
+        *value = l->value;
+    }
+    free(l);
+    t->size--;
+    return 1;
+}
+
+// Visit leaves in lexicographic key order; a non-zero callback result stops
+static int iterate(ArtNode* n, ArtCallback cb, void* data) {
+    if (n == NULL) {
+        return 0;
+    }
+    if (IS_LEAF(n)) {
+        ArtLeaf* l = LEAF_RAW(n);
+        return cb(data, l->key, l->keyLen - 1, l->value);
+    }
+
+    int res;
+    switch (n->type) {
+    case NODE4:
+        for (int i = 0; i < n->numChildren; i++) {
+            if ((res = iterate(((ArtNode4*)n)->children[i], cb, data))) return res;
+        }
+        break;
+    case NODE16:
+        for (int i = 0; i < n->numChildren; i++) {
+            if ((res = iterate(((ArtNode16*)n)->children[i], cb, data))) return res;
+        }
+        break;
+    case NODE48: {
+        ArtNode48* p = (ArtNode48*)n;
+        for (int i = 0; i < 256; i++) {
+            if (p->childIndex[i] && (res = iterate(p->children[p->childIndex[i] - 1], cb, data))) return res;
+        }
+        break;
+    }
+    case NODE256:
+        for (int i = 0; i < 256; i++) {
+            if ((res = iterate(((ArtNode256*)n)->children[i], cb, data))) return res;
+        }
+        break;
+    }
+    return 0;
+}
+
+int artIterate(const ArtTree* t, ArtCallback cb, void* data) {
+    return iterate(t->root, cb, data);
+}
+
+// Visit, in order, every key that starts with the given prefix
+int artPrefixScan(const ArtTree* t, const char* str, ArtCallback cb, void* data) {
+    const unsigned char* prefix = (const unsigned char*)str;
+    uint32_t prefixLen = strlen(str);
+    ArtNode* n = t->root;
+    uint32_t depth = 0;
+
+    while (n != NULL) {
+        if (IS_LEAF(n)) {
+            ArtLeaf* l = LEAF_RAW(n);
+            if (l->keyLen > prefixLen && memcmp(l->key, prefix, prefixLen) == 0) {
+                return cb(data, l->key, l->keyLen - 1, l->value);
+            }
+            return 0;
+        }
+        if (depth == prefixLen) {
+            return iterate(n, cb, data);
+        }
+        if (n->prefixLen) {
+            uint32_t matched = prefixMismatch(n, prefix, prefixLen, depth);
+            if (matched < n->prefixLen) {
+                // Either the query ends inside this node's path, or it diverges
+                return depth + matched == prefixLen ? iterate(n, cb, data) : 0;
+            }
+            depth += n->prefixLen;
+            if (depth == prefixLen) {
+                return iterate(n, cb, data);
+            }
+        }
+        ArtNode** child = findChild(n, prefix[depth]);
+        n = child ? *child : NULL;
+        depth++;
+    }
+    return 0;
+}
+
+/* ---------- Chained hash table with one bucket per key, for comparison ---------- */
+
+typedef struct HashNode {
+    char* key;
+    int value;
+    struct HashNode* next;
+} HashNode;
+
+typedef struct {
+    HashNode** buckets;
+    size_t size;
+} HashTable;
+
+static size_t hashString(const char* key) {
+    size_t h = 14695981039346656037ULL;
+    while (*key) {
+        h = (h ^ (unsigned char)*key++) * 1099511628211ULL;
+    }
+    return h;
+}
+
+void hashInsert(HashTable* table, const char* key, int value) {
+    size_t index = hashString(key) % table->size;
+    HashNode* node = (HashNode*)malloc(sizeof(HashNode));
+    node->key = strdup(key);
+    node->value = value;
+    node->next = table->buckets[index];
+    table->buckets[index] = node;
+}
+
+int hashSearch(const HashTable* table, const char* key) {
+    for (HashNode* cur = table->buckets[hashString(key) % table->size]; cur; cur = cur->next) {
+        if (strcmp(cur->key, key) == 0) return cur->value;
+    }
+    return -1;
+}
+
+void freeHashTable(HashTable* table) {
+    for (size_t i = 0; i < table->size; i++) {
+        HashNode* cur = table->buckets[i];
+        while (cur) {
+            HashNode* next = cur->next;
+            free(cur->key);
+            free(cur);
+            cur = next;
+        }
+    }
+    free(table->buckets);
+}
+
+/* ---------- Demo and benchmark ---------- */
+
+static int printKey(void* data, const unsigned char* key, uint32_t keyLen, int value) {
+    (void)data;
+    printf("  %.*s -> %d\n", (int)keyLen, (const char*)key, value);
+    return 0;
+}
+
+static int countKey(void* data, const unsigned char* key, uint32_t keyLen, int value) {
+    (void)key;
+    (void)keyLen;
+    (void)value;
+    (*(long*)data)++;
+    return 0;
+}
+
+static void makeUrl(char* buf, unsigned i) {
+    static const char* hosts[] = {"api.example.com", "cdn.example.net", "www.shop.org", "docs.example.io"};
+    unsigned h = i * 2654435761u;
+    sprintf(buf, "https://%s/v%u/users/%u/items/%u", hosts[h % 4], h % 3 + 1, (h >> 8) % 100000, i);
+}
+
+static size_t heapInUse(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;  // Large blocks are mmap()ed separately
+#else
+    return 0;
+#endif
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned n = argc > 1 ? (unsigned)atol(argv[1]) : 1000000;
+    char url[128];
+
+    ArtTree tree;
+    artInit(&tree);
+    artInsert(&tree, "user:alice", 1);
+    artInsert(&tree, "user:bob", 2);
+    artInsert(&tree, "user:carol", 3);
+    artInsert(&tree, "group:admins", 4);
+    artInsert(&tree, "user:al", 5);
+
+    printf("Ordered iteration:\n");
+    artIterate(&tree, printKey, NULL);
+    printf("Prefix scan \"user:al\":\n");
+    artPrefixScan(&tree, "user:al", printKey, NULL);
+    int value;
+    if (artDelete(&tree, "user:bob", &value)) {
+        printf("Delete user:bob -> %d, ", value);
+    }
+    printf("search user:bob -> %s\n\n", artSearch(&tree, "user:bob", &value) ? "found" : "not found");
+    artDestroy(&tree);
+
+    // Benchmark: URL-like keys, ART against a hash table with n buckets
+    unsigned* order = (unsigned*)malloc(n * sizeof(unsigned));
+    for (unsigned i = 0; i < n; i++) order[i] = i;
+    srand(1);
+    for (unsigned i = n - 1; i > 0; i--) {
+        unsigned j = ((unsigned)rand() * 32768u + rand()) % (i + 1);
+        unsigned t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    size_t before = heapInUse();
+    double start = nowSeconds();
+    for (unsigned i = 0; i < n; i++) {
+        makeUrl(url, i);
+        artInsert(&tree, url, i);
+    }
+    double artBuild = nowSeconds() - start;
+    size_t artBytes = heapInUse() - before;
+
+    before = heapInUse();
+    HashTable table = {(HashNode**)calloc(n, sizeof(HashNode*)), n};
+    start = nowSeconds();
+    for (unsigned i = 0; i < n; i++) {
+        makeUrl(url, i);
+        hashInsert(&table, url, i);
+    }
+    double hashBuild = nowSeconds() - start;
+    size_t hashBytes = heapInUse() - before;
+
+    // Pre-generate lookup keys so only the lookups are timed
+    char** keys = (char**)malloc(n * sizeof(char*));
+    for (unsigned i = 0; i < n; i++) {
+        makeUrl(url, order[i]);
+        keys[i] = strdup(url);
+    }
+
+    long artFound = 0, hashFound = 0;
+    start = nowSeconds();
+    for (unsigned i = 0; i < n; i++) artFound += artSearch(&tree, keys[i], &value);
+    double artLookup = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (unsigned i = 0; i < n; i++) hashFound += hashSearch(&table, keys[i]) >= 0;
+    double hashLookup = nowSeconds() - start;
+
+    long inPrefix = 0;
+    start = nowSeconds();
+    artPrefixScan(&tree, "https://api.example.com/v2/", countKey, &inPrefix);
+    double scan = nowSeconds() - start;
+
+    printf("%u URL-like keys\n", n);
+    printf("%-12s %12s %14s %14s\n", "", "bytes/key", "insert ns/key", "lookup ns/key");
+    printf("%-12s %12.1f %14.1f %14.1f (found %ld)\n", "ART", (double)artBytes / n,
+           artBuild * 1e9 / n, artLookup * 1e9 / n, artFound);
+    printf("%-12s %12.1f %14.1f %14.1f (found %ld)\n", "Hash table", (double)hashBytes / n,
+           hashBuild * 1e9 / n, hashLookup * 1e9 / n, hashFound);
+    printf("Prefix scan https://api.example.com/v2/: %ld keys in %.1f ms (not possible with the hash table)\n",
+           inPrefix, scan * 1e3);
+
+    for (unsigned i = 0; i < n; i++) free(keys[i]);
+    free(keys);
+    free(order);
+    freeHashTable(&table);
+    artDestroy(&tree);
+    return 0;
+}
\ No newline at end of file
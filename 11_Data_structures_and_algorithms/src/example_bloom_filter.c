@@ -0,0 +1,330 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define TABLE_SIZE 1024
+#define BLOCK_WORDS 8  // 8 x 32-bit words = one 32-byte block inside a cache line
+
+/* ---------- Chained hash table (as in example_hash_table.c) ---------- */
+
+typedef struct Node {
+    char* key;
+    int value;
+    struct Node* next;
+} Node;
+
+typedef struct {
+    Node* buckets[TABLE_SIZE];
+} HashTable;
+
+unsigned int hash(const char* key) {
+    unsigned long int value = 0;
+    unsigned int key_len = strlen(key);
+
+    for (unsigned int i = 0; i < key_len; ++i) {
+        value = value * 37 + key[i];
+    }
+    return value % TABLE_SIZE;
+}
+
+void insert(HashTable* table, const char* key, int value) {
+    unsigned int index = hash(key);
+    Node* new_node = (Node*)malloc(sizeof(Node));
+    new_node->key = strdup(key);
+    new_node->value = value;
+    new_node->next = table->buckets[index];
+    table->buckets[index] = new_node;
+}
+
+int search(HashTable* table, const char* key) {
+    Node* current = table->buckets[hash(key)];
+    while (current != NULL) {
+        if (strcmp(current->key, key) == 0) {
+            return current->value;
+        }
+        current = current->next;
+    }
+    return -1;  // Key not found
+}
+
+void freeHashTable(HashTable* table) {
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        Node* current = table->buckets[i];
+        while (current != NULL) {
+            Node* temp = current;
+            current = current->next;
+            free(temp->key);
+            free(temp);
+        }
+        table->buckets[i] = NULL;
+    }
+}
+
+/* ---------- Split-block Bloom filter ---------- */
+
+// Every key maps to a single 32-byte block and sets one bit in each of its
+// eight 32-bit words, so a lookup touches exactly one cache line.
+typedef struct {
+    uint32_t (*blocks)[BLOCK_WORDS];
+    uint64_t numBlocks;
+} BloomFilter;
+
+// Counting variant: a counter per bit makes delete() possible. The plain bit
+// filter is kept in sync so lookups stay on the fast path.
+typedef struct {
+    BloomFilter bits;
+    uint8_t* counters;  // BLOCK_WORDS * 32 counters per block
+} CountingBloomFilter;
+
+static const uint32_t SALT[BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+// 64-bit FNV-1a followed by a finalizer to spread the bits
+uint64_t hash64(const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+int initBloomFilter(BloomFilter* filter, uint64_t expectedKeys, double bitsPerKey) {
+    uint64_t bits = (uint64_t)(expectedKeys * bitsPerKey);
+    filter->numBlocks = bits / (BLOCK_WORDS * 32) + 1;
+    size_t bytes = filter->numBlocks * sizeof(*filter->blocks);
+    filter->blocks = aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+    if (filter->blocks == NULL) {
+        return -1;
+    }
+    memset(filter->blocks, 0, bytes);
+    return 0;
+}
+
+void freeBloomFilter(BloomFilter* filter) {
+    free(filter->blocks);
+    filter->blocks = NULL;
+}
+
+static inline uint64_t blockIndex(const BloomFilter* filter, uint64_t h) {
+    // Multiply-shift maps the high 32 bits onto [0, numBlocks) without a division
+    return ((h >> 32) * filter->numBlocks) >> 32;
+}
+
+static inline void makeMask(uint32_t h, uint32_t mask[BLOCK_WORDS]) {
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        mask[i] = 1U << ((h * SALT[i]) >> 27);
+    }
+}
+
+void bloomAddHash(BloomFilter* filter, uint64_t h) {
+    uint32_t* block = filter->blocks[blockIndex(filter, h)];
+    uint32_t mask[BLOCK_WORDS];
+    makeMask((uint32_t)h, mask);
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        block[i] |= mask[i];
+    }
+}
+
+// Returns 0 if the key is definitely absent, 1 if it may be present
+int bloomContainsHash(const BloomFilter* filter, uint64_t h) {
+    const uint32_t* block = filter->blocks[blockIndex(filter, h)];
+#ifdef __AVX2__
+    // Compute all eight bit positions and test them with one vector compare
+    const __m256i salt = _mm256_loadu_si256((const __m256i*)SALT);
+    __m256i hv = _mm256_mullo_epi32(_mm256_set1_epi32((uint32_t)h), salt);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(hv, 27));
+    __m256i data = _mm256_load_si256((const __m256i*)block);
+    return _mm256_testc_si256(data, mask);
+#else
+    uint32_t mask[BLOCK_WORDS];
+    makeMask((uint32_t)h, mask);
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        if ((block[i] & mask[i]) == 0) {
+            return 0;
+        }
+    }
+    return 1;
+#endif
+}
+
+void bloomAdd(BloomFilter* filter, const void* key, size_t len) {
+    bloomAddHash(filter, hash64(key, len));
+}
+
+int bloomContains(const BloomFilter* filter, const void* key, size_t len) {
+    return bloomContainsHash(filter, hash64(key, len));
+}
+
+int initCountingBloomFilter(CountingBloomFilter* filter, uint64_t expectedKeys, double bitsPerKey) {
+    if (initBloomFilter(&filter->bits, expectedKeys, bitsPerKey) != 0) {
+        return -1;
+    }
+    filter->counters = (uint8_t*)calloc(filter->bits.numBlocks * BLOCK_WORDS * 32, 1);
+    if (filter->counters == NULL) {
+        freeBloomFilter(&filter->bits);
+        return -1;
+    }
+    return 0;
+}
+
+void freeCountingBloomFilter(CountingBloomFilter* filter) {
+    freeBloomFilter(&filter->bits);
+    free(filter->counters);
+    filter->counters = NULL;
+}
+
+void countingBloomAdd(CountingBloomFilter* filter, const void* key, size_t len) {
+    uint64_t h = hash64(key, len);
+    uint64_t b = blockIndex(&filter->bits, h);
+    uint8_t* counters = filter->counters + b * BLOCK_WORDS * 32;
+
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        uint32_t bit = ((uint32_t)h * SALT[i]) >> 27;
+        // A saturated counter sticks at 255 so it can never underflow to 0
+        if (counters[i * 32 + bit] < UINT8_MAX) {
+            counters[i * 32 + bit]++;
+        }
+        filter->bits.blocks[b][i] |= 1U << bit;
+    }
+}
+
+// Only delete keys that were added, otherwise other keys may be lost
+void countingBloomDelete(CountingBloomFilter* filter, const void* key, size_t len) {
+    uint64_t h = hash64(key, len);
+    uint64_t b = blockIndex(&filter->bits, h);
+    uint8_t* counters = filter->counters + b * BLOCK_WORDS * 32;
+
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        uint32_t bit = ((uint32_t)h * SALT[i]) >> 27;
+        uint8_t* c = &counters[i * 32 + bit];
+        if (*c == UINT8_MAX || *c == 0) {
+            continue;
+        }
+        if (--*c == 0) {
+            filter->bits.blocks[b][i] &= ~(1U << bit);
+        }
+    }
+}
+
+int countingBloomContains(const CountingBloomFilter* filter, const void* key, size_t len) {
+    return bloomContainsHash(&filter->bits, hash64(key, len));
+}
+
+/* ---------- Filter in front of the hash table ---------- */
+
+int filteredSearch(HashTable* table, const BloomFilter* filter, const char* key) {
+    if (!bloomContains(filter, key, strlen(key))) {
+        return -1;  // Definitely not in the table, skip the chain walk
+    }
+    return search(table, key);
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void makeKey(char* buf, int i) {
+    sprintf(buf, "user:%d:session", i);
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    char key[64];
+
+    // Demo: counting filter with delete
+    CountingBloomFilter counting;
+    initCountingBloomFilter(&counting, 100, 10);
+    countingBloomAdd(&counting, "apple", 5);
+    countingBloomAdd(&counting, "banana", 6);
+    printf("Counting filter: apple=%d banana=%d grape=%d\n",
+           countingBloomContains(&counting, "apple", 5),
+           countingBloomContains(&counting, "banana", 6),
+           countingBloomContains(&counting, "grape", 5));
+    countingBloomDelete(&counting, "banana", 6);
+    printf("After deleting banana: apple=%d banana=%d\n\n",
+           countingBloomContains(&counting, "apple", 5),
+           countingBloomContains(&counting, "banana", 6));
+    freeCountingBloomFilter(&counting);
+
+    // False-positive rate and raw lookup throughput for several sizes
+    printf("%d keys inserted, %d absent keys queried\n", n, n);
+    printf("%12s %12s %16s\n", "bits/key", "FP rate", "Mlookups/s");
+    double sizes[] = {8, 10, 12, 16};
+    for (int s = 0; s < 4; s++) {
+        BloomFilter filter;
+        initBloomFilter(&filter, n, sizes[s]);
+        for (int i = 0; i < n; i++) {
+            bloomAddHash(&filter, hash64(&i, sizeof(i)));
+        }
+
+        uint64_t* hashes = (uint64_t*)malloc(n * sizeof(uint64_t));
+        for (int i = 0; i < n; i++) {
+            int absent = n + i;
+            hashes[i] = hash64(&absent, sizeof(absent));
+        }
+
+        long positives = 0;
+        double start = nowSeconds();
+        for (int i = 0; i < n; i++) {
+            positives += bloomContainsHash(&filter, hashes[i]);
+        }
+        double elapsed = nowSeconds() - start;
+
+        printf("%12.0f %11.3f%% %16.1f\n", sizes[s], 100.0 * positives / n, n / elapsed / 1e6);
+        free(hashes);
+        freeBloomFilter(&filter);
+    }
+
+    // Miss-heavy workload against the chained hash table
+    HashTable* table = (HashTable*)calloc(1, sizeof(HashTable));
+    BloomFilter filter;
+    initBloomFilter(&filter, n, 10);
+    for (int i = 0; i < n; i++) {
+        makeKey(key, i);
+        insert(table, key, i);
+        bloomAdd(&filter, key, strlen(key));
+    }
+
+    int queries = n / 10;
+    long sum = 0;
+    double start = nowSeconds();
+    for (int i = 0; i < queries; i++) {
+        makeKey(key, i % 10 == 0 ? i : n + i);  // 90% misses
+        sum += search(table, key);
+    }
+    double plain = nowSeconds() - start;
+
+    long filteredSum = 0;
+    start = nowSeconds();
+    for (int i = 0; i < queries; i++) {
+        makeKey(key, i % 10 == 0 ? i : n + i);
+        filteredSum += filteredSearch(table, &filter, key);
+    }
+    double filtered = nowSeconds() - start;
+
+    printf("\nHash table, 90%% misses, %d lookups:\n", queries);
+    printf("  search():         %8.1f ns/lookup\n", plain * 1e9 / queries);
+    printf("  filteredSearch(): %8.1f ns/lookup (%s)\n", filtered * 1e9 / queries,
+           sum == filteredSum ? "same results" : "MISMATCH");
+
+    freeBloomFilter(&filter);
+    freeHashTable(table);
+    free(table);
+    return 0;
+}
\ No newline at end of file
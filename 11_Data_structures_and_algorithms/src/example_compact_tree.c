@@ -0,0 +1,456 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define NIL UINT32_MAX
+#define SNAPSHOT_MAGIC 0x45455254u  // "TREE"
+
+// Classic pointer-based node: one malloc per node, two 64-bit child pointers
+struct Node {
+    int data;
+    struct Node* left;
+    struct Node* right;
+};
+
+// Compact node: 32-bit child indices into one contiguous array (12 bytes)
+typedef struct {
+    int32_t data;
+    uint32_t left;
+    uint32_t right;
+} CompactNode;
+
+typedef struct {
+    CompactNode* nodes;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t root;
+} CompactTree;
+
+// Header written in front of the node array in a snapshot file
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    uint32_t root;
+    uint32_t reserved;
+} SnapshotHeader;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ---------- Pointer-based BST (baseline) ---------- */
+
+struct Node* createNode(int data) {
+    struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
+    newNode->data = data;
+    newNode->left = NULL;
+    newNode->right = NULL;
+    return newNode;
+}
+
+struct Node* insert(struct Node* root, int data) {
+    struct Node** link = &root;
+    while (*link != NULL) {
+        if (data < (*link)->data) {
+            link = &(*link)->left;
+        } else if (data > (*link)->data) {
+            link = &(*link)->right;
+        } else {
+            return root;
+        }
+    }
+    *link = createNode(data);
+    return root;
+}
+
+struct Node* search(struct Node* root, int data) {
+    while (root != NULL && root->data != data) {
+        root = data < root->data ? root->left : root->right;
+    }
+    return root;
+}
+
+void freeTree(struct Node* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+/* ---------- Compact index-based BST ---------- */
+
+void initCompactTree(CompactTree* tree, uint32_t capacity) {
+    tree->nodes = capacity > 0 ? (CompactNode*)malloc(capacity * sizeof(CompactNode)) : NULL;
+    tree->count = 0;
+    tree->capacity = tree->nodes != NULL ? capacity : 0;  // Grows on the first insert
+    tree->root = NIL;
+}
+
+void freeCompactTree(CompactTree* tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->count = tree->capacity = 0;
+    tree->root = NIL;
+}
+
+// Returns the index of the new node, or NIL if out of memory
+static uint32_t allocCompactNode(CompactTree* tree, int data) {
+    if (tree->count == tree->capacity) {
+        // Indices stay valid when the array moves, unlike pointers
+        uint32_t capacity = tree->capacity > 0 ? tree->capacity * 2 : 16;
+        CompactNode* nodes = (CompactNode*)realloc(tree->nodes, capacity * sizeof(CompactNode));
+        if (nodes == NULL) {
+            return NIL;
+        }
+        tree->nodes = nodes;
+        tree->capacity = capacity;
+    }
+    uint32_t index = tree->count++;
+    tree->nodes[index].data = data;
+    tree->nodes[index].left = NIL;
+    tree->nodes[index].right = NIL;
+    return index;
+}
+
+// Returns 0 on success (or if data is already present), -1 if out of memory
+int compactInsert(CompactTree* tree, int data) {
+    uint32_t* link = &tree->root;
+    while (*link != NIL) {
+        CompactNode* node = &tree->nodes[*link];
+        if (data < node->data) {
+            link = &node->left;
+        } else if (data > node->data) {
+            link = &node->right;
+        } else {
+            return 0;
+        }
+    }
+    // Compute the slot offset first: allocCompactNode() may move the array
+    ptrdiff_t offset = (char*)link - (char*)tree->nodes;
+    int isRoot = (link == &tree->root);
+    uint32_t index = allocCompactNode(tree, data);
+    if (index == NIL) {
+        return -1;
+    }
+    if (isRoot) {
+        tree->root = index;
+    } else {
+        *(uint32_t*)((char*)tree->nodes + offset) = index;
+    }
+    return 0;
+}
+
+// Search works on any node array, including one mapped straight from a file
+uint32_t compactSearch(const CompactNode* nodes, uint32_t root, int data) {
+    uint32_t i = root;
+    while (i != NIL && nodes[i].data != data) {
+        i = data < nodes[i].data ? nodes[i].left : nodes[i].right;
+    }
+    return i;
+}
+
+// Rewrite the tree so that nodes[k] is the node at position k of `order`.
+// Returns 0 on success, -1 if out of memory (the tree is left unchanged).
+static int applyLayout(CompactTree* tree, const uint32_t* order) {
+    uint32_t* newIndex = (uint32_t*)malloc(tree->count * sizeof(uint32_t));
+    CompactNode* nodes = (CompactNode*)malloc(tree->count * sizeof(CompactNode));
+    if (newIndex == NULL || nodes == NULL) {
+        free(newIndex);
+        free(nodes);
+        return -1;
+    }
+
+    for (uint32_t k = 0; k < tree->count; k++) {
+        newIndex[order[k]] = k;
+    }
+    for (uint32_t k = 0; k < tree->count; k++) {
+        CompactNode old = tree->nodes[order[k]];
+        nodes[k].data = old.data;
+        nodes[k].left = old.left == NIL ? NIL : newIndex[old.left];
+        nodes[k].right = old.right == NIL ? NIL : newIndex[old.right];
+    }
+
+    free(tree->nodes);
+    free(newIndex);
+    tree->nodes = nodes;
+    tree->capacity = tree->count;
+    tree->root = tree->count > 0 ? 0 : NIL;
+    return 0;
+}
+
+// Breadth-first layout: the top levels of the tree share a few cache lines.
+// Returns 0 on success, -1 if out of memory.
+int layoutBfs(CompactTree* tree) {
+    if (tree->count == 0) {
+        return 0;
+    }
+    uint32_t* order = (uint32_t*)malloc(tree->count * sizeof(uint32_t));
+    uint32_t head = 0, tail = 0;
+    if (order == NULL) {
+        return -1;
+    }
+
+    if (tree->root != NIL) {
+        order[tail++] = tree->root;
+    }
+    while (head < tail) {
+        CompactNode* node = &tree->nodes[order[head++]];
+        if (node->left != NIL) order[tail++] = node->left;
+        if (node->right != NIL) order[tail++] = node->right;
+    }
+
+    int result = applyLayout(tree, order);
+    free(order);
+    return result;
+}
+
+static int treeHeight(const CompactTree* tree, uint32_t i) {
+    if (i == NIL) {
+        return 0;
+    }
+    int l = treeHeight(tree, tree->nodes[i].left);
+    int r = treeHeight(tree, tree->nodes[i].right);
+    return 1 + (l > r ? l : r);
+}
+
+static void collectAtDepth(const CompactTree* tree, uint32_t i, int depth,
+                           uint32_t* out, uint32_t* count) {
+    if (i == NIL) {
+        return;
+    }
+    if (depth == 0) {
+        out[(*count)++] = i;
+        return;
+    }
+    collectAtDepth(tree, tree->nodes[i].left, depth - 1, out, count);
+    collectAtDepth(tree, tree->nodes[i].right, depth - 1, out, count);
+}
+
+// Lay out the first `height` levels below node i in van Emde Boas order:
+// the top half of the levels first, then each bottom subtree recursively.
+// Each call keeps the roots of its bottom subtrees on top of the scratch
+// stack. The roots held by nested calls lie at different depths, so they
+// are distinct nodes and tree->count entries are always enough.
+static void vebPlace(const CompactTree* tree, uint32_t i, int height,
+                     uint32_t* order, uint32_t* pos, uint32_t* scratch) {
+    if (i == NIL || height == 0) {
+        return;
+    }
+    if (height == 1) {
+        order[(*pos)++] = i;
+        return;
+    }
+
+    int top = height / 2;
+    vebPlace(tree, i, top, order, pos, scratch);
+
+    uint32_t rootCount = 0;
+    collectAtDepth(tree, i, top, scratch, &rootCount);
+    for (uint32_t k = 0; k < rootCount; k++) {
+        vebPlace(tree, scratch[k], height - top, order, pos, scratch + rootCount);
+    }
+}
+
+// Van Emde Boas layout: every root-to-leaf path touches O(log_B n) cache
+// lines for any cache line size B, without knowing B in advance.
+// Returns 0 on success, -1 if out of memory.
+int layoutVeb(CompactTree* tree) {
+    if (tree->count == 0) {
+        return 0;
+    }
+    uint32_t* order = (uint32_t*)malloc(tree->count * sizeof(uint32_t));
+    uint32_t* scratch = (uint32_t*)malloc(tree->count * sizeof(uint32_t));
+    uint32_t pos = 0;
+    int result = -1;
+
+    if (order != NULL && scratch != NULL) {
+        vebPlace(tree, tree->root, treeHeight(tree, tree->root), order, &pos, scratch);
+        result = applyLayout(tree, order);
+    }
+    free(order);
+    free(scratch);
+    return result;
+}
+
+/* ---------- Snapshots ---------- */
+
+// The node array has no pointers, so a snapshot is a single write.
+// Returns 0 on success, -1 on error.
+int saveSnapshot(const CompactTree* tree, const char* path) {
+    SnapshotHeader header = {SNAPSHOT_MAGIC, tree->count, tree->root, 0};
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("Error opening snapshot for writing");
+        return -1;
+    }
+    int failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    failed |= fwrite(tree->nodes, sizeof(CompactNode), tree->count, file) != tree->count;
+    failed |= fclose(file) != 0;  // Buffered data is only written here
+    if (failed) {
+        perror("Error writing snapshot");
+        remove(path);
+        return -1;
+    }
+    return 0;
+}
+
+// Every layout places a node before its children, so requiring child indices
+// to grow keeps a search inside the array and guarantees it ends
+static int validSnapshot(const CompactNode* nodes, uint32_t count, uint32_t root) {
+    if (count == 0 ? root != NIL : root >= count) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t left = nodes[i].left, right = nodes[i].right;
+        if ((left != NIL && (left <= i || left >= count)) || (right != NIL && (right <= i || right >= count))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Map a snapshot read-only; the returned nodes can be searched in place
+const CompactNode* mapSnapshot(const char* path, SnapshotHeader* header, size_t* length) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        perror("Error opening snapshot");
+        return NULL;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || (size_t)sb.st_size < sizeof(SnapshotHeader)) {
+        fprintf(stderr, "Invalid snapshot file\n");
+        close(fd);
+        return NULL;
+    }
+
+    void* base = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("Error mapping snapshot");
+        return NULL;
+    }
+
+    memcpy(header, base, sizeof(SnapshotHeader));
+    const CompactNode* nodes = (const CompactNode*)((const char*)base + sizeof(SnapshotHeader));
+    if (header->magic != SNAPSHOT_MAGIC ||
+        sizeof(SnapshotHeader) + (size_t)header->count * sizeof(CompactNode) > (size_t)sb.st_size ||
+        !validSnapshot(nodes, header->count, header->root)) {
+        fprintf(stderr, "Corrupt snapshot file\n");
+        munmap(base, sb.st_size);
+        return NULL;
+    }
+
+    *length = sb.st_size;
+    return nodes;
+}
+
+/* ---------- Benchmark ---------- */
+
+static void shuffle(int* a, int n) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+    }
+}
+
+static void report(const char* name, double bytesPerNode, uint64_t ns, int queries, long found) {
+    printf("%-24s %8.1f bytes/node %8.1f ns/search (found %ld)\n",
+           name, bytesPerNode, (double)ns / queries, found);
+}
+
+static void benchCompact(const char* name, const CompactTree* tree, const int* queries, int q) {
+    long found = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < q; i++) {
+        found += compactSearch(tree->nodes, tree->root, queries[i]) != NIL;
+    }
+    report(name, (double)tree->capacity * sizeof(CompactNode) / tree->count, nowNs() - start, q, found);
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int q = n;
+    const char* snapshotPath = "tree.snapshot";
+
+    int* keys = (int*)malloc(n * sizeof(int));
+    int* queries = (int*)malloc(q * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        keys[i] = i * 2;  // Even keys are present, odd keys are misses
+    }
+    srand(42);
+    shuffle(keys, n);
+    for (int i = 0; i < q; i++) {
+        queries[i] = rand() % (2 * n);
+    }
+
+    printf("%d keys, %d random lookups (about half are misses)\n\n", n, q);
+
+    // Baseline: pointer tree, one malloc per node
+    struct Node* root = NULL;
+    for (int i = 0; i < n; i++) {
+        root = insert(root, keys[i]);
+    }
+    // Each node also pays for the allocator's header and rounding
+    double pointerBytes = (double)malloc_usable_size(root) + sizeof(size_t);
+    long found = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < q; i++) {
+        found += search(root, queries[i]) != NULL;
+    }
+    report("Pointer nodes (malloc)", pointerBytes, nowNs() - start, q, found);
+    freeTree(root);
+
+    // Same insertion order, same tree shape, but nodes live in one array
+    CompactTree tree;
+    initCompactTree(&tree, 1024);
+    for (int i = 0; i < n; i++) {
+        if (compactInsert(&tree, keys[i]) != 0) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+    }
+    benchCompact("Compact, insert order", &tree, queries, q);
+
+    if (layoutBfs(&tree) == 0) {
+        benchCompact("Compact, BFS order", &tree, queries, q);
+    }
+    if (layoutVeb(&tree) == 0) {
+        benchCompact("Compact, vEB order", &tree, queries, q);
+    }
+
+    // Snapshot round trip: write the array once, then search the mapping
+    if (saveSnapshot(&tree, snapshotPath) == 0) {
+        SnapshotHeader header;
+        size_t length;
+        const CompactNode* mapped = mapSnapshot(snapshotPath, &header, &length);
+        if (mapped != NULL) {
+            found = 0;
+            start = nowNs();
+            for (int i = 0; i < q; i++) {
+                found += compactSearch(mapped, header.root, queries[i]) != NIL;
+            }
+            report("Compact, mmap snapshot", (double)sizeof(CompactNode), nowNs() - start, q, found);
+            munmap((void*)((const char*)mapped - sizeof(SnapshotHeader)), length);
+        }
+        remove(snapshotPath);
+    }
+
+    freeCompactTree(&tree);
+    free(keys);
+    free(queries);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,562 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MAX_LEVEL 24
+#define MAX_THREADS 128
+#define RETIRE_BATCH 64
+
+#define INSERTER_DONE 1
+#define DELETER_DONE 2
+
+// Lowest bit of a next pointer marks the node as logically deleted at that level
+#define IS_MARKED(p) ((p) & 1)
+#define MARK(p) ((p) | 1)
+#define UNMARK(p) ((p) & ~(uintptr_t)1)
+#define NODE(p) ((SkipNode*)UNMARK(p))
+
+typedef struct SkipNode {
+    long key;
+    _Atomic long value;
+    int height;
+    _Atomic int done;  // INSERTER_DONE | DELETER_DONE; the last one retires the node
+    _Atomic uintptr_t next[];
+} SkipNode;
+
+// The sentinels are recognised by address, never by key, so every long
+// (LONG_MIN and LONG_MAX included) is a valid key
+typedef struct {
+    SkipNode* head;
+    SkipNode* tail;
+} SkipList;
+
+typedef void (*RangeCallback)(void* data, long key, long value);
+
+/* ---------- Epoch-based reclamation ---------- */
+
+// A removed node may still be read by threads that found it before it was
+// unlinked. It is only freed once every active thread has moved on by two
+// epochs, which guarantees none of them can still hold a reference.
+typedef struct {
+    _Atomic unsigned long epoch;
+    _Atomic int active;
+    _Atomic int inUse;
+    SkipNode** retired;
+    unsigned long* retiredEpoch;
+    size_t count;
+    size_t capacity;
+    char pad[64];  // Keep records of different threads on separate cache lines
+} EpochRecord;
+
+static EpochRecord records[MAX_THREADS];
+static _Atomic int numRecords;
+static _Atomic unsigned long globalEpoch;
+static _Thread_local EpochRecord* self;
+static _Thread_local uint64_t rngState;
+
+// Claim a free record; records (and their pending retired nodes) are reused
+// by later threads once their previous owner has unregistered
+void epochRegisterThread(void) {
+    for (int id = 0; id < MAX_THREADS; id++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&records[id].inUse, &expected, 1)) {
+            int n = atomic_load(&numRecords);
+            while (n <= id && !atomic_compare_exchange_weak(&numRecords, &n, id + 1)) {
+            }
+            self = &records[id];
+            rngState = 0x9e3779b97f4a7c15ULL * (uintptr_t)&rngState + id + 1;
+            return;
+        }
+    }
+    fprintf(stderr, "Too many threads\n");
+    exit(1);
+}
+
+void epochUnregisterThread(void) {
+    atomic_store(&self->inUse, 0);
+    self = NULL;
+}
+
+static void epochEnter(void) {
+    atomic_store(&self->active, 1);
+    atomic_store(&self->epoch, atomic_load(&globalEpoch));
+}
+
+static void epochExit(void) {
+    atomic_store(&self->active, 0);
+}
+
+static void tryAdvanceEpoch(void) {
+    unsigned long e = atomic_load(&globalEpoch);
+    int n = atomic_load(&numRecords);
+    for (int i = 0; i < n; i++) {
+        if (atomic_load(&records[i].active) && atomic_load(&records[i].epoch) != e) {
+            return;
+        }
+    }
+    atomic_compare_exchange_strong(&globalEpoch, &e, e + 1);
+}
+
+static void reclaim(EpochRecord* rec, unsigned long safeBefore) {
+    size_t kept = 0;
+    for (size_t i = 0; i < rec->count; i++) {
+        if (rec->retiredEpoch[i] + 2 <= safeBefore) {
+            free(rec->retired[i]);
+        } else {
+            rec->retired[kept] = rec->retired[i];
+            rec->retiredEpoch[kept++] = rec->retiredEpoch[i];
+        }
+    }
+    rec->count = kept;
+}
+
+// Must be called inside epochEnter()/epochExit(), after the node is unreachable
+static void retire(SkipNode* node) {
+    EpochRecord* rec = self;
+    if (rec->count == rec->capacity) {
+        rec->capacity = rec->capacity ? rec->capacity * 2 : 256;
+        rec->retired = (SkipNode**)realloc(rec->retired, rec->capacity * sizeof(SkipNode*));
+        rec->retiredEpoch = (unsigned long*)realloc(rec->retiredEpoch, rec->capacity * sizeof(unsigned long));
+    }
+    rec->retired[rec->count] = node;
+    rec->retiredEpoch[rec->count++] = atomic_load(&globalEpoch);
+
+    if (rec->count % RETIRE_BATCH == 0) {
+        tryAdvanceEpoch();
+        reclaim(rec, atomic_load(&globalEpoch));
+    }
+}
+
+/* ---------- Lock-free skip list ---------- */
+
+static SkipNode* createSkipNode(long key, long value, int height) {
+    SkipNode* node = (SkipNode*)malloc(sizeof(SkipNode) + height * sizeof(_Atomic uintptr_t));
+    node->key = key;
+    atomic_init(&node->value, value);
+    node->height = height;
+    atomic_init(&node->done, 0);
+    for (int i = 0; i < height; i++) {
+        atomic_init(&node->next[i], 0);
+    }
+    return node;
+}
+
+// Each level is kept with probability 1/2
+static int randomHeight(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    int height = 1 + __builtin_ctzll(rngState | (1ULL << (MAX_LEVEL - 1)));
+    return height;
+}
+
+void initSkipList(SkipList* list) {
+    list->head = createSkipNode(0, 0, MAX_LEVEL);
+    list->tail = createSkipNode(0, 0, MAX_LEVEL);
+    for (int i = 0; i < MAX_LEVEL; i++) {
+        atomic_init(&list->head->next[i], (uintptr_t)list->tail);
+    }
+}
+
+// Fill preds/succs with the nodes around key on every level and unlink any
+// marked nodes on the way. Returns 1 if an unmarked node with key exists.
+static int find(SkipList* list, long key, SkipNode** preds, SkipNode** succs) {
+retry:;
+    SkipNode* pred = list->head;
+    SkipNode* curr = NULL;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+        curr = NODE(atomic_load(&pred->next[level]));
+        while (1) {
+            uintptr_t succ = atomic_load(&curr->next[level]);
+            while (IS_MARKED(succ)) {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!atomic_compare_exchange_strong(&pred->next[level], &expected, UNMARK(succ))) {
+                    goto retry;
+                }
+                curr = NODE(succ);
+                succ = atomic_load(&curr->next[level]);
+            }
+            if (curr != list->tail && curr->key < key) {
+                pred = curr;
+                curr = NODE(succ);
+            } else {
+                break;
+            }
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return curr != list->tail && curr->key == key;
+}
+
+// Insert or update; returns 1 if the key was new
+int skipListInsert(SkipList* list, long key, long value) {
+    SkipNode* preds[MAX_LEVEL];
+    SkipNode* succs[MAX_LEVEL];
+    SkipNode* node;
+
+    epochEnter();
+    int height = randomHeight();
+    while (1) {
+        if (find(list, key, preds, succs)) {
+            atomic_store(&succs[0]->value, value);
+            epochExit();
+            return 0;
+        }
+        node = createSkipNode(key, value, height);
+        for (int i = 0; i < height; i++) {
+            atomic_init(&node->next[i], (uintptr_t)succs[i]);
+        }
+        // Linking the bottom level is the linearization point of the insert
+        uintptr_t expected = (uintptr_t)succs[0];
+        if (atomic_compare_exchange_strong(&preds[0]->next[0], &expected, (uintptr_t)node)) {
+            break;
+        }
+        free(node);  // Never published, so it can be freed directly
+    }
+
+    // The upper levels are only shortcuts and are linked one by one
+    for (int level = 1; level < height; level++) {
+        while (1) {
+            SkipNode* succ = succs[level];
+            // Never link over another node with the same key
+            if (succ != list->tail && succ->key == key) {
+                goto linked;
+            }
+            uintptr_t current = atomic_load(&node->next[level]);
+            if (IS_MARKED(current)) {
+                goto linked;  // Deleted while being inserted
+            }
+            if (current != (uintptr_t)succ &&
+                !atomic_compare_exchange_strong(&node->next[level], &current, (uintptr_t)succ)) {
+                goto linked;
+            }
+            uintptr_t expected = (uintptr_t)succ;
+            if (atomic_compare_exchange_strong(&preds[level]->next[level], &expected, (uintptr_t)node)) {
+                break;
+            }
+            find(list, key, preds, succs);
+        }
+    }
+
+linked:
+    // A concurrent delete may have missed levels linked after it cleaned up
+    if (IS_MARKED(atomic_load(&node->next[0]))) {
+        find(list, key, preds, succs);
+    }
+    if (atomic_fetch_or(&node->done, INSERTER_DONE) & DELETER_DONE) {
+        retire(node);
+    }
+    epochExit();
+    return 1;
+}
+
+// Returns 1 and stores the value in *value if key is present, 0 otherwise
+int skipListSearch(SkipList* list, long key, long* value) {
+    int found = 0;
+
+    epochEnter();
+    // Wait-free read: skip over marked nodes without helping to unlink them
+    SkipNode* pred = list->head;
+    SkipNode* curr = NULL;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+        curr = NODE(atomic_load(&pred->next[level]));
+        while (1) {
+            uintptr_t succ = atomic_load(&curr->next[level]);
+            while (IS_MARKED(succ)) {
+                curr = NODE(succ);
+                succ = atomic_load(&curr->next[level]);
+            }
+            if (curr != list->tail && curr->key < key) {
+                pred = curr;
+                curr = NODE(succ);
+            } else {
+                break;
+            }
+        }
+    }
+    if (curr != list->tail && curr->key == key) {
+        *value = atomic_load(&curr->value);
+        found = 1;
+    }
+    epochExit();
+    return found;
+}
+
+// Returns 1 if key was removed (storing its value in *value unless value is
+// NULL), 0 if it was not present
+int skipListDelete(SkipList* list, long key, long* value) {
+    SkipNode* preds[MAX_LEVEL];
+    SkipNode* succs[MAX_LEVEL];
+
+    epochEnter();
+    if (!find(list, key, preds, succs)) {
+        epochExit();
+        return 0;
+    }
+    SkipNode* node = succs[0];
+
+    // Mark the upper levels top-down so no new links are built on them
+    for (int level = node->height - 1; level >= 1; level--) {
+        uintptr_t succ = atomic_load(&node->next[level]);
+        while (!IS_MARKED(succ) &&
+               !atomic_compare_exchange_weak(&node->next[level], &succ, MARK(succ))) {
+        }
+    }
+
+    // Whoever marks the bottom level owns the delete
+    uintptr_t succ = atomic_load(&node->next[0]);
+    while (1) {
+        if (IS_MARKED(succ)) {
+            epochExit();
+            return 0;
+        }
+        if (atomic_compare_exchange_weak(&node->next[0], &succ, MARK(succ))) {
+            break;
+        }
+    }
+
+    if (value != NULL) {
+        *value = atomic_load(&node->value);
+    }
+    find(list, key, preds, succs);  // Physically unlink on every level
+    if (atomic_fetch_or(&node->done, DELETER_DONE) & INSERTER_DONE) {
+        retire(node);
+    }
+    epochExit();
+    return 1;
+}
+
+// Visit every key in [low, high] in order. The scan is weakly consistent:
+// it sees each key that stays present for the whole scan.
+void skipListRangeScan(SkipList* list, long low, long high, RangeCallback cb, void* data) {
+    SkipNode* preds[MAX_LEVEL];
+    SkipNode* succs[MAX_LEVEL];
+
+    epochEnter();
+    find(list, low, preds, succs);
+    SkipNode* curr = succs[0];
+    while (curr != list->tail && curr->key <= high) {
+        uintptr_t succ = atomic_load(&curr->next[0]);
+        if (!IS_MARKED(succ)) {
+            cb(data, curr->key, atomic_load(&curr->value));
+        }
+        curr = NODE(succ);
+    }
+    epochExit();
+}
+
+// Only call when no other thread uses the list
+void destroySkipList(SkipList* list) {
+    SkipNode* curr = list->head;
+    while (curr != NULL) {
+        SkipNode* next = curr == list->tail ? NULL : NODE(atomic_load(&curr->next[0]));
+        free(curr);
+        curr = next;
+    }
+    int n = atomic_load(&numRecords);
+    for (int i = 0; i < n; i++) {
+        reclaim(&records[i], ULONG_MAX);
+        free(records[i].retired);
+        free(records[i].retiredEpoch);
+        records[i].retired = NULL;
+        records[i].retiredEpoch = NULL;
+        records[i].count = records[i].capacity = 0;
+    }
+}
+
+/* ---------- Baseline: the chapter's BST behind one mutex ---------- */
+
+struct Node {
+    long data;
+    struct Node* left;
+    struct Node* right;
+};
+
+typedef struct {
+    struct Node* root;
+    pthread_mutex_t lock;
+} LockedBst;
+
+static struct Node* bstInsert(struct Node* root, long data) {
+    if (root == NULL) {
+        struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
+        newNode->data = data;
+        newNode->left = newNode->right = NULL;
+        return newNode;
+    }
+    if (data < root->data) {
+        root->left = bstInsert(root->left, data);
+    } else if (data > root->data) {
+        root->right = bstInsert(root->right, data);
+    }
+    return root;
+}
+
+static struct Node* bstDelete(struct Node* root, long data) {
+    if (root == NULL) {
+        return NULL;
+    }
+    if (data < root->data) {
+        root->left = bstDelete(root->left, data);
+    } else if (data > root->data) {
+        root->right = bstDelete(root->right, data);
+    } else if (root->left == NULL || root->right == NULL) {
+        struct Node* child = root->left ? root->left : root->right;
+        free(root);
+        return child;
+    } else {
+        struct Node* min = root->right;
+        while (min->left != NULL) min = min->left;
+        root->data = min->data;
+        root->right = bstDelete(root->right, min->data);
+    }
+    return root;
+}
+
+static int bstContains(struct Node* root, long data) {
+    while (root != NULL && root->data != data) {
+        root = data < root->data ? root->left : root->right;
+    }
+    return root != NULL;
+}
+
+static void bstFree(struct Node* root) {
+    if (root != NULL) {
+        bstFree(root->left);
+        bstFree(root->right);
+        free(root);
+    }
+}
+
+/* ---------- Benchmark ---------- */
+
+#define KEY_RANGE (1 << 20)
+
+typedef struct {
+    SkipList* list;
+    LockedBst* bst;
+    int millis;
+    long ops;
+} WorkerArgs;
+
+static _Atomic int stopFlag;
+
+static uint64_t nextRandom(uint64_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+// 80% search, 10% insert, 10% delete on random keys
+static void* worker(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    uint64_t seed = (uintptr_t)arg * 2654435761u + 1;
+    long ops = 0;
+    long value;
+
+    if (args->list != NULL) {
+        epochRegisterThread();
+    }
+    while (!atomic_load_explicit(&stopFlag, memory_order_relaxed)) {
+        for (int i = 0; i < 256; i++) {
+            uint64_t r = nextRandom(&seed);
+            long key = (long)((r >> 8) % KEY_RANGE);
+            int op = r % 10;
+            if (args->list != NULL) {
+                if (op == 0) skipListInsert(args->list, key, key);
+                else if (op == 1) skipListDelete(args->list, key, NULL);
+                else skipListSearch(args->list, key, &value);
+            } else {
+                pthread_mutex_lock(&args->bst->lock);
+                if (op == 0) args->bst->root = bstInsert(args->bst->root, key);
+                else if (op == 1) args->bst->root = bstDelete(args->bst->root, key);
+                else bstContains(args->bst->root, key);
+                pthread_mutex_unlock(&args->bst->lock);
+            }
+        }
+        ops += 256;
+    }
+    if (args->list != NULL) {
+        epochUnregisterThread();
+    }
+    args->ops = ops;
+    return NULL;
+}
+
+static double runBenchmark(SkipList* list, LockedBst* bst, int threads, int millis) {
+    pthread_t tids[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+
+    atomic_store(&stopFlag, 0);
+    for (int i = 0; i < threads; i++) {
+        args[i] = (WorkerArgs){list, bst, millis, 0};
+        pthread_create(&tids[i], NULL, worker, &args[i]);
+    }
+
+    struct timespec delay = {millis / 1000, (millis % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+    atomic_store(&stopFlag, 1);
+
+    long total = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+        total += args[i].ops;
+    }
+    return total / (millis / 1000.0) / 1e6;
+}
+
+static void printEntry(void* data, long key, long value) {
+    (void)data;
+    printf("%ld=%ld ", key, value);
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : 64;
+    int millis = argc > 2 ? atoi(argv[2]) : 500;
+    if (maxThreads > MAX_THREADS - 2) maxThreads = MAX_THREADS - 2;
+
+    SkipList list;
+    initSkipList(&list);
+    epochRegisterThread();
+
+    for (long k = 10; k <= 100; k += 10) {
+        skipListInsert(&list, k, k * k);
+    }
+    skipListDelete(&list, 50, NULL);
+    long value;
+    if (skipListSearch(&list, 40, &value)) {
+        printf("Search 40: %ld, ", value);
+    }
+    printf("search 50: %s\n", skipListSearch(&list, 50, &value) ? "found" : "not found");
+    printf("Range [25, 75]: ");
+    skipListRangeScan(&list, 25, 75, printEntry, NULL);
+    printf("\n\n");
+
+    // Prefill half of the key range for both structures
+    LockedBst bst = {NULL, PTHREAD_MUTEX_INITIALIZER};
+    uint64_t seed = 12345;
+    for (int i = 0; i < KEY_RANGE / 2; i++) {
+        long key = (long)(nextRandom(&seed) % KEY_RANGE);
+        skipListInsert(&list, key, key);
+        bst.root = bstInsert(bst.root, key);
+    }
+
+    printf("80%% search / 10%% insert / 10%% delete, %d keys, %d ms per run\n", KEY_RANGE, millis);
+    printf("%8s %20s %20s\n", "threads", "skip list Mops/s", "mutex BST Mops/s");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double skip = runBenchmark(&list, NULL, threads, millis);
+        double locked = runBenchmark(NULL, &bst, threads, millis);
+        printf("%8d %20.2f %20.2f\n", threads, skip, locked);
+    }
+
+    destroySkipList(&list);
+    bstFree(bst.root);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct Node {
+    int data;
+    struct Node* left;
+    struct Node* right;
+};
+
+typedef enum {
+    PRE_ORDER,
+    IN_ORDER,
+    POST_ORDER,
+    LEVEL_ORDER
+} TraversalOrder;
+
+// Pull-style iterator: the caller asks for the next node instead of the
+// traversal calling printf(). The explicit stack (or queue for level order)
+// replaces the call stack, so deep trees cannot overflow it.
+typedef struct {
+    TraversalOrder order;
+    struct Node** items;
+    int capacity;
+    int head;                  // Queue front (level order only)
+    int top;                   // Stack top / queue rear
+    struct Node* current;      // Cursor for in-order and post-order
+    struct Node* lastVisited;  // Last node returned in post-order
+} TreeIterator;
+
+struct Node* createNode(int data) {
+    struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
+    newNode->data = data;
+    newNode->left = NULL;
+    newNode->right = NULL;
+    return newNode;
+}
+
+// Build a perfectly balanced tree from arr[low..high] (sorted) in O(n)
+struct Node* buildBalancedTree(const int arr[], int low, int high) {
+    if (low > high) {
+        return NULL;
+    }
+
+    int mid = low + (high - low) / 2;
+    struct Node* root = createNode(arr[mid]);
+    root->left = buildBalancedTree(arr, low, mid - 1);
+    root->right = buildBalancedTree(arr, mid + 1, high);
+    return root;
+}
+
+void freeTree(struct Node* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+static void push(TreeIterator* it, struct Node* node) {
+    if (it->top == it->capacity) {
+        it->capacity *= 2;
+        it->items = (struct Node**)realloc(it->items, it->capacity * sizeof(struct Node*));
+    }
+    it->items[it->top++] = node;
+}
+
+TreeIterator* createIterator(struct Node* root, TraversalOrder order) {
+    TreeIterator* it = (TreeIterator*)malloc(sizeof(TreeIterator));
+    it->order = order;
+    it->capacity = 64;
+    it->items = (struct Node**)malloc(it->capacity * sizeof(struct Node*));
+    it->head = 0;
+    it->top = 0;
+    it->current = NULL;
+    it->lastVisited = NULL;
+
+    if (order == IN_ORDER || order == POST_ORDER) {
+        it->current = root;
+    } else if (root != NULL) {
+        push(it, root);
+    }
+    return it;
+}
+
+void freeIterator(TreeIterator* it) {
+    free(it->items);
+    free(it);
+}
+
+// Return the next node in the chosen order, or NULL when the traversal is done
+struct Node* nextNode(TreeIterator* it) {
+    struct Node* node;
+
+    switch (it->order) {
+    case PRE_ORDER:
+        if (it->top == 0) {
+            return NULL;
+        }
+        node = it->items[--it->top];
+        // Push right first so that the left subtree is visited first
+        if (node->right != NULL) push(it, node->right);
+        if (node->left != NULL) push(it, node->left);
+        return node;
+
+    case IN_ORDER:
+        while (it->current != NULL) {
+            push(it, it->current);
+            it->current = it->current->left;
+        }
+        if (it->top == 0) {
+            return NULL;
+        }
+        node = it->items[--it->top];
+        it->current = node->right;
+        return node;
+
+    case POST_ORDER:
+        while (it->current != NULL || it->top > 0) {
+            if (it->current != NULL) {
+                push(it, it->current);
+                it->current = it->current->left;
+            } else {
+                node = it->items[it->top - 1];
+                if (node->right != NULL && it->lastVisited != node->right) {
+                    it->current = node->right;
+                } else {
+                    it->top--;
+                    it->lastVisited = node;
+                    return node;
+                }
+            }
+        }
+        return NULL;
+
+    case LEVEL_ORDER:
+        if (it->head == it->top) {
+            return NULL;
+        }
+        node = it->items[it->head++];
+        // Reclaim the consumed front of the queue before it grows again
+        if (it->head == it->top) {
+            it->head = it->top = 0;
+        }
+        if (node->left != NULL) push(it, node->left);
+        if (node->right != NULL) push(it, node->right);
+        return node;
+    }
+    return NULL;
+}
+
+void printTraversal(struct Node* root, TraversalOrder order, const char* name) {
+    TreeIterator* it = createIterator(root, order);
+    struct Node* node;
+
+    printf("%-12s: ", name);
+    while ((node = nextNode(it)) != NULL) {
+        printf("%d ", node->data);
+    }
+    printf("\n");
+    freeIterator(it);
+}
+
+int main() {
+    int sorted[] = {10, 20, 30, 40, 50, 60, 70};
+    int n = sizeof(sorted) / sizeof(sorted[0]);
+
+    struct Node* root = buildBalancedTree(sorted, 0, n - 1);
+
+    printTraversal(root, PRE_ORDER, "Pre-order");
+    printTraversal(root, IN_ORDER, "In-order");
+    printTraversal(root, POST_ORDER, "Post-order");
+    printTraversal(root, LEVEL_ORDER, "Level-order");
+
+    // Stream the tree into another stage (here: a running sum) without recursion
+    TreeIterator* it = createIterator(root, IN_ORDER);
+    struct Node* node;
+    long sum = 0;
+    while ((node = nextNode(it)) != NULL) {
+        sum += node->data;
+    }
+    freeIterator(it);
+    printf("Sum of streamed values: %ld\n", sum);
+    freeTree(root);
+
+    // Rebuild a large index from sorted keys
+    int count = 1000000;
+    int* keys = (int*)malloc(count * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        keys[i] = i * 2;
+    }
+
+    clock_t start = clock();
+    root = buildBalancedTree(keys, 0, count - 1);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Built balanced tree of %d keys in %.3f s\n", count, elapsed);
+
+    // Verify the in-order stream reproduces the sorted input
+    it = createIterator(root, IN_ORDER);
+    int i = 0, ok = 1;
+    while ((node = nextNode(it)) != NULL) {
+        if (node->data != keys[i++]) {
+            ok = 0;
+        }
+    }
+    freeIterator(it);
+    printf("In-order matches sorted input: %s\n", (ok && i == count) ? "yes" : "no");
+
+    freeTree(root);
+    free(keys);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,649 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <aio.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define MAX_WORKERS 64
+#define MAX_FILES 16
+
+// Called when a read finishes. result is the number of bytes read, or -errno.
+typedef void (*IoCallback)(void* context, ssize_t result);
+
+typedef struct IoRequest {
+    int fd;
+    void* buffer;
+    size_t length;
+    off_t offset;
+    IoCallback callback;
+    void* context;
+    ssize_t result;
+    struct IoRequest* next;
+} IoRequest;
+
+typedef enum { ENGINE_URING, ENGINE_THREADS } EngineKind;
+
+typedef struct {
+    EngineKind kind;
+    unsigned depth;     // Maximum number of reads in flight
+    unsigned inFlight;
+    IoRequest* slots;   // One per possible read in flight
+    IoRequest* freeSlots;
+    int files[MAX_FILES];
+    int fileCount;
+
+    // io_uring: shared rings, mapped from the kernel
+    int ringFd;
+    void* sqRing;
+    void* cqRing;
+    size_t sqRingSize, cqRingSize;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    unsigned sqEntries;
+    unsigned toSubmit;    // Queued in the ring, not yet passed to the kernel
+    int filesRegistered;
+    struct iovec registered;  // Registered buffer, if any
+
+    // Thread pool: workers run pread() and move requests to the done list
+    pthread_t workers[MAX_WORKERS];
+    int workerCount;
+    pthread_mutex_t lock;
+    pthread_cond_t work, finished;
+    IoRequest *queueHead, *queueTail;
+    IoRequest *batchHead, *batchTail;  // Not yet submitted
+    IoRequest* done;
+    int stop;
+} IoEngine;
+
+/* ---------- io_uring backend ---------- */
+
+static int uringSetup(IoEngine* e) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    e->ringFd = (int)syscall(__NR_io_uring_setup, e->depth, &params);
+    if (e->ringFd < 0) {
+        return -1;
+    }
+
+    e->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    e->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && e->cqRingSize > e->sqRingSize) {
+        e->sqRingSize = e->cqRingSize;
+    }
+    e->sqRing = mmap(NULL, e->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, e->ringFd,
+                     IORING_OFF_SQ_RING);
+    e->cqRing = single ? e->sqRing
+                       : mmap(NULL, e->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, e->ringFd,
+                              IORING_OFF_CQ_RING);
+    e->sqes = (struct io_uring_sqe*)mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+                                         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, e->ringFd,
+                                         IORING_OFF_SQES);
+    if (e->sqRing == MAP_FAILED || e->cqRing == MAP_FAILED || e->sqes == MAP_FAILED) {
+        if (e->sqes != MAP_FAILED) munmap(e->sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+        if (e->cqRing != MAP_FAILED && e->cqRing != e->sqRing) munmap(e->cqRing, e->cqRingSize);
+        if (e->sqRing != MAP_FAILED) munmap(e->sqRing, e->sqRingSize);
+        close(e->ringFd);
+        return -1;
+    }
+
+    char* sq = (char*)e->sqRing;
+    char* cq = (char*)e->cqRing;
+    e->sqHead = (unsigned*)(sq + params.sq_off.head);
+    e->sqTail = (unsigned*)(sq + params.sq_off.tail);
+    e->sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+    e->sqArray = (unsigned*)(sq + params.sq_off.array);
+    e->cqHead = (unsigned*)(cq + params.cq_off.head);
+    e->cqTail = (unsigned*)(cq + params.cq_off.tail);
+    e->cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    e->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    e->sqEntries = params.sq_entries;
+    return 0;
+}
+
+static void uringTeardown(IoEngine* e) {
+    munmap(e->sqes, e->sqEntries * sizeof(struct io_uring_sqe));
+    if (e->cqRing != e->sqRing) {
+        munmap(e->cqRing, e->cqRingSize);
+    }
+    munmap(e->sqRing, e->sqRingSize);
+    close(e->ringFd);
+}
+
+// IORING_OP_READ only exists since 5.6, so a ring from an older kernel would
+// fail every read with -EINVAL. The probe arrived in 5.6 as well; if it
+// fails, the reads are missing too. Returns 0 if both read opcodes work.
+static int uringProbe(IoEngine* e) {
+    struct io_uring_probe* probe = (struct io_uring_probe*)calloc(
+        1, sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op));
+    if (probe == NULL) {
+        return -1;
+    }
+    int ok = syscall(__NR_io_uring_register, e->ringFd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0 &&
+             probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+             (probe->ops[IORING_OP_READ_FIXED].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    return ok ? 0 : -1;
+}
+
+static int uringEnter(IoEngine* e, unsigned submit, unsigned minComplete) {
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        int n = (int)syscall(__NR_io_uring_enter, e->ringFd, submit, minComplete, flags, NULL, 0);
+        if (n >= 0 || errno != EINTR) {
+            return n;
+        }
+    }
+}
+
+// Fill the next submission queue entry; no system call
+static void uringQueue(IoEngine* e, IoRequest* request, int fileIndex) {
+    unsigned tail = *e->sqTail;
+    unsigned index = tail & *e->sqMask;
+    struct io_uring_sqe* sqe = &e->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+
+    char* buffer = (char*)request->buffer;
+    char* base = (char*)e->registered.iov_base;
+    if (base != NULL && buffer >= base && buffer + request->length <= base + e->registered.iov_len) {
+        sqe->opcode = IORING_OP_READ_FIXED;  // Pages are already pinned
+        sqe->buf_index = 0;
+    } else {
+        sqe->opcode = IORING_OP_READ;
+    }
+    if (e->filesRegistered) {
+        sqe->fd = fileIndex;
+        sqe->flags = IOSQE_FIXED_FILE;  // No file lookup per request
+    } else {
+        sqe->fd = request->fd;
+    }
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = (uint32_t)request->length;
+    sqe->off = (uint64_t)request->offset;
+    sqe->user_data = (uint64_t)(uintptr_t)request;
+
+    e->sqArray[index] = index;
+    __atomic_store_n(e->sqTail, tail + 1, __ATOMIC_RELEASE);
+    e->toSubmit++;
+}
+
+// Move finished requests from the completion queue to the front of a list,
+// adding their number to *count
+static IoRequest* uringReap(IoEngine* e, IoRequest* finished, unsigned* count) {
+    unsigned head = *e->cqHead;
+    unsigned tail = __atomic_load_n(e->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        struct io_uring_cqe* cqe = &e->cqes[head & *e->cqMask];
+        IoRequest* request = (IoRequest*)(uintptr_t)cqe->user_data;
+        request->result = cqe->res;
+        request->next = finished;
+        finished = request;
+        (*count)++;
+    }
+    __atomic_store_n(e->cqHead, head, __ATOMIC_RELEASE);
+    return finished;
+}
+
+/* ---------- Thread pool backend ---------- */
+
+static void* workerMain(void* arg) {
+    IoEngine* e = (IoEngine*)arg;
+    pthread_mutex_lock(&e->lock);
+    for (;;) {
+        while (e->queueHead == NULL && !e->stop) {
+            pthread_cond_wait(&e->work, &e->lock);
+        }
+        if (e->queueHead == NULL) {
+            break;
+        }
+        IoRequest* request = e->queueHead;
+        e->queueHead = request->next;
+        pthread_mutex_unlock(&e->lock);
+
+        ssize_t n = pread(request->fd, request->buffer, request->length, request->offset);
+        request->result = n < 0 ? -errno : n;
+
+        pthread_mutex_lock(&e->lock);
+        request->next = e->done;
+        e->done = request;
+        pthread_cond_signal(&e->finished);
+    }
+    pthread_mutex_unlock(&e->lock);
+    return NULL;
+}
+
+static int poolSetup(IoEngine* e) {
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->work, NULL);
+    pthread_cond_init(&e->finished, NULL);
+    // pread() blocks, so each read in flight needs its own thread
+    int count = e->depth < MAX_WORKERS ? (int)e->depth : MAX_WORKERS;
+    for (; e->workerCount < count; e->workerCount++) {
+        if (pthread_create(&e->workers[e->workerCount], NULL, workerMain, e) != 0) {
+            break;
+        }
+    }
+    return e->workerCount > 0 ? 0 : -1;
+}
+
+/* ---------- Engine ---------- */
+
+// Up to depth reads can be in flight. forceThreads = 1 skips io_uring.
+// Returns 0 on success, -1 if neither backend could be started.
+int ioEngineInit(IoEngine* e, unsigned depth, int forceThreads) {
+    memset(e, 0, sizeof(*e));
+    e->depth = depth;
+    e->slots = (IoRequest*)calloc(depth, sizeof(IoRequest));
+    if (e->slots == NULL) {
+        return -1;
+    }
+    for (unsigned i = 0; i < depth; i++) {
+        e->slots[i].next = e->freeSlots;
+        e->freeSlots = &e->slots[i];
+    }
+
+    if (!forceThreads && uringSetup(e) == 0) {
+        if (uringProbe(e) == 0) {
+            e->kind = ENGINE_URING;
+            return 0;
+        }
+        uringTeardown(e);
+    }
+    // Kernels before 5.6, seccomp filters or io_uring_disabled=2
+    e->kind = ENGINE_THREADS;
+    if (poolSetup(e) != 0) {
+        free(e->slots);
+        return -1;
+    }
+    return 0;
+}
+
+// Register the files once, so later reads refer to them by index.
+// Returns 0 on success, -1 on error.
+int ioEngineRegisterFiles(IoEngine* e, const int* fds, int count) {
+    if (count > MAX_FILES) {
+        return -1;
+    }
+    memcpy(e->files, fds, count * sizeof(int));
+    e->fileCount = count;
+    if (e->kind == ENGINE_URING) {
+        // Optional for io_uring: without it each read looks up the fd
+        e->filesRegistered =
+            syscall(__NR_io_uring_register, e->ringFd, IORING_REGISTER_FILES, fds, (unsigned)count) == 0;
+    }
+    return 0;
+}
+
+// Pin one buffer region in the kernel; reads into it skip the per-request
+// page mapping. Returns 0 if registered, -1 if reads will use it unregistered.
+int ioEngineRegisterBuffer(IoEngine* e, void* buffer, size_t size) {
+    if (e->kind != ENGINE_URING) {
+        return -1;
+    }
+    struct iovec region = {buffer, size};
+    if (syscall(__NR_io_uring_register, e->ringFd, IORING_REGISTER_BUFFERS, &region, 1) != 0) {
+        return -1;
+    }
+    e->registered = region;
+    return 0;
+}
+
+// Queue a read of length bytes at offset from registered file fileIndex.
+// Nothing is sent until ioEngineSubmit(). Returns -1 if depth reads are
+// already in flight.
+int ioEngineRead(IoEngine* e, int fileIndex, void* buffer, size_t length, off_t offset, IoCallback callback,
+                 void* context) {
+    IoRequest* request = e->freeSlots;
+    if (request == NULL || fileIndex < 0 || fileIndex >= e->fileCount) {
+        return -1;
+    }
+    e->freeSlots = request->next;
+    e->inFlight++;
+    request->fd = e->files[fileIndex];
+    request->buffer = buffer;
+    request->length = length;
+    request->offset = offset;
+    request->callback = callback;
+    request->context = context;
+    request->next = NULL;
+
+    if (e->kind == ENGINE_URING) {
+        uringQueue(e, request, fileIndex);
+    } else if (e->batchTail != NULL) {
+        e->batchTail->next = request;
+        e->batchTail = request;
+    } else {
+        e->batchHead = e->batchTail = request;
+    }
+    return 0;
+}
+
+// Send all queued reads with one system call (io_uring) or one lock (pool)
+int ioEngineSubmit(IoEngine* e) {
+    if (e->kind == ENGINE_URING) {
+        if (e->toSubmit == 0) {
+            return 0;
+        }
+        int n = uringEnter(e, e->toSubmit, 0);
+        if (n < 0) {
+            return -1;
+        }
+        e->toSubmit -= n;
+        return 0;
+    }
+    if (e->batchHead != NULL) {
+        pthread_mutex_lock(&e->lock);
+        if (e->queueHead == NULL) {
+            e->queueHead = e->batchHead;
+        } else {
+            e->queueTail->next = e->batchHead;
+        }
+        e->queueTail = e->batchTail;
+        pthread_cond_broadcast(&e->work);
+        pthread_mutex_unlock(&e->lock);
+        e->batchHead = e->batchTail = NULL;
+    }
+    return 0;
+}
+
+// Submit queued reads, wait until at least minComplete reads have finished
+// and run their callbacks on the calling thread. Returns the number of
+// callbacks run, which is only below minComplete if waiting failed, or -1
+// if it failed before any read finished.
+int ioEngineComplete(IoEngine* e, unsigned minComplete) {
+    if (minComplete > e->inFlight) {
+        minComplete = e->inFlight;
+    }
+    IoRequest* finished;
+    int failed = 0;
+    if (e->kind == ENGINE_URING) {
+        unsigned reaped = 0;
+        finished = uringReap(e, NULL, &reaped);
+        if (e->toSubmit > 0 || reaped < minComplete) {
+            // Submitting and waiting is a single io_uring_enter() call. It can
+            // return early (a signal), so wait again for the rest.
+            do {
+                int n = uringEnter(e, e->toSubmit, reaped < minComplete ? minComplete - reaped : 0);
+                if (n < 0) {
+                    failed = 1;
+                    break;
+                }
+                e->toSubmit -= n;
+                finished = uringReap(e, finished, &reaped);
+            } while (reaped < minComplete);
+        }
+    } else {
+        ioEngineSubmit(e);
+        pthread_mutex_lock(&e->lock);
+        unsigned available = 0;
+        for (;;) {
+            available = 0;
+            for (IoRequest* r = e->done; r != NULL && available < minComplete; r = r->next) {
+                available++;
+            }
+            if (available >= minComplete) {
+                break;
+            }
+            pthread_cond_wait(&e->finished, &e->lock);
+        }
+        finished = e->done;
+        e->done = NULL;
+        pthread_mutex_unlock(&e->lock);
+    }
+
+    int count = 0;
+    while (finished != NULL) {
+        IoRequest* request = finished;
+        finished = request->next;
+        // Free the slot first so the callback can queue the next read
+        request->next = e->freeSlots;
+        e->freeSlots = request;
+        e->inFlight--;
+        request->callback(request->context, request->result);
+        count++;
+    }
+    return failed && count == 0 ? -1 : count;
+}
+
+// Waits for all reads in flight, then releases the backend
+void ioEngineDestroy(IoEngine* e) {
+    while (e->inFlight > 0 && ioEngineComplete(e, e->inFlight) >= 0) {
+    }
+    if (e->kind == ENGINE_URING) {
+        uringTeardown(e);
+    } else {
+        pthread_mutex_lock(&e->lock);
+        e->stop = 1;
+        pthread_cond_broadcast(&e->work);
+        pthread_mutex_unlock(&e->lock);
+        for (int i = 0; i < e->workerCount; i++) {
+            pthread_join(e->workers[i], NULL);
+        }
+        pthread_mutex_destroy(&e->lock);
+        pthread_cond_destroy(&e->work);
+        pthread_cond_destroy(&e->finished);
+    }
+    free(e->slots);
+}
+
+/* ---------- Benchmark ---------- */
+
+#define BLOCK 4096
+
+typedef struct {
+    IoEngine* engine;
+    char* buffers;      // depth blocks
+    int* freeBuffers;   // Stack of unused block numbers
+    int freeCount;
+    uint64_t* expected; // Block number being read into each buffer
+    long errors;
+    long completed;
+} Bench;
+
+typedef struct {
+    Bench* bench;
+    int buffer;
+} BenchSlot;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Every block starts with its own block number
+static int checkBlock(const char* data, ssize_t result, uint64_t block) {
+    uint64_t stored;
+    memcpy(&stored, data, sizeof(stored));
+    return result == BLOCK && stored == block;
+}
+
+static void onRead(void* context, ssize_t result) {
+    BenchSlot* slot = (BenchSlot*)context;
+    Bench* b = slot->bench;
+    if (!checkBlock(b->buffers + (size_t)slot->buffer * BLOCK, result, b->expected[slot->buffer])) {
+        b->errors++;
+    }
+    b->completed++;
+    b->freeBuffers[b->freeCount++] = slot->buffer;
+}
+
+// Random 4 KiB reads with depth reads in flight; returns thousand reads/s
+static double runEngine(int fd, uint64_t blocks, unsigned depth, long reads, int forceThreads, long* errors,
+                        EngineKind* kind) {
+    IoEngine engine;
+    if (ioEngineInit(&engine, depth, forceThreads) != 0) {
+        return 0;
+    }
+    *kind = engine.kind;
+    Bench b = {&engine, NULL, NULL, 0, NULL, 0, 0};
+    b.buffers = (char*)aligned_alloc(BLOCK, (size_t)depth * BLOCK);  // O_DIRECT needs alignment
+    b.freeBuffers = (int*)malloc(depth * sizeof(int));
+    b.expected = (uint64_t*)malloc(depth * sizeof(uint64_t));
+    BenchSlot* slots = (BenchSlot*)malloc(depth * sizeof(BenchSlot));
+    for (unsigned i = 0; i < depth; i++) {
+        b.freeBuffers[b.freeCount++] = (int)i;
+        slots[i].bench = &b;
+        slots[i].buffer = (int)i;
+    }
+    ioEngineRegisterFiles(&engine, &fd, 1);
+    ioEngineRegisterBuffer(&engine, b.buffers, (size_t)depth * BLOCK);
+
+    uint64_t seed = 88172645463325252ULL;
+    long issued = 0;
+    double start = nowSeconds();
+    while (b.completed < reads) {
+        // Refill every free slot, then submit them all at once
+        while (issued < reads && b.freeCount > 0) {
+            int buffer = b.freeBuffers[--b.freeCount];
+            uint64_t block = nextRandom(&seed) % blocks;
+            b.expected[buffer] = block;
+            ioEngineRead(&engine, 0, b.buffers + (size_t)buffer * BLOCK, BLOCK, (off_t)(block * BLOCK), onRead,
+                         &slots[buffer]);
+            issued++;
+        }
+        if (ioEngineComplete(&engine, 1) < 0) {
+            perror("ioEngineComplete");
+            break;
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    ioEngineDestroy(&engine);
+    *errors += b.errors;
+    free(slots);
+    free(b.expected);
+    free(b.freeBuffers);
+    free(b.buffers);
+    return b.completed / elapsed / 1e3;
+}
+
+// The same reads with POSIX AIO, waiting in aio_suspend() instead of polling
+static double runAio(int fd, uint64_t blocks, unsigned depth, long reads, long* errors) {
+    struct aiocb* cbs = (struct aiocb*)calloc(depth, sizeof(struct aiocb));
+    const struct aiocb** list = (const struct aiocb**)calloc(depth, sizeof(struct aiocb*));
+    uint64_t* expected = (uint64_t*)malloc(depth * sizeof(uint64_t));
+    char* buffers = (char*)aligned_alloc(BLOCK, (size_t)depth * BLOCK);
+    uint64_t seed = 88172645463325252ULL;
+    long issued = 0, completed = 0;
+
+    double start = nowSeconds();
+    for (unsigned i = 0; i < depth && issued < reads; i++, issued++) {
+        expected[i] = nextRandom(&seed) % blocks;
+        cbs[i].aio_fildes = fd;
+        cbs[i].aio_buf = buffers + (size_t)i * BLOCK;
+        cbs[i].aio_nbytes = BLOCK;
+        cbs[i].aio_offset = (off_t)(expected[i] * BLOCK);
+        aio_read(&cbs[i]);
+        list[i] = &cbs[i];
+    }
+    while (completed < reads) {
+        aio_suspend(list, depth, NULL);
+        // AIO has no completion queue: every request has to be checked
+        for (unsigned i = 0; i < depth; i++) {
+            if (list[i] == NULL || aio_error(&cbs[i]) == EINPROGRESS) {
+                continue;
+            }
+            if (!checkBlock((const char*)cbs[i].aio_buf, aio_return(&cbs[i]), expected[i])) {
+                (*errors)++;
+            }
+            completed++;
+            list[i] = NULL;
+            if (issued < reads) {
+                expected[i] = nextRandom(&seed) % blocks;
+                cbs[i].aio_offset = (off_t)(expected[i] * BLOCK);
+                aio_read(&cbs[i]);
+                list[i] = &cbs[i];
+                issued++;
+            }
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    free(buffers);
+    free(expected);
+    free(list);
+    free(cbs);
+    return completed / elapsed / 1e3;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = "io_test.dat";
+    size_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 256;
+    long reads = argc > 2 ? atol(argv[2]) : 20000;
+    uint64_t blocks = (mib << 20) / BLOCK;
+
+    // Test file: every 4 KiB block starts with its block number
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    static char block[BLOCK];
+    for (uint64_t i = 0; i < blocks; i++) {
+        memcpy(block, &i, sizeof(i));
+        fwrite(block, 1, BLOCK, file);
+    }
+    fclose(file);
+
+    // O_DIRECT bypasses the page cache so the reads reach the device
+    int fd = open(path, O_RDONLY | O_DIRECT);
+    int direct = fd >= 0;
+    if (!direct) {
+        fd = open(path, O_RDONLY);
+    }
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+
+    IoEngine probe;
+    int haveUring = 0;
+    if (ioEngineInit(&probe, 1, 0) == 0) {
+        haveUring = probe.kind == ENGINE_URING;
+        ioEngineDestroy(&probe);
+    }
+
+    printf("%s: %zu MiB, %ld random 4 KiB reads per run%s\n", path, mib, reads,
+           direct ? ", O_DIRECT" : ", page cache (O_DIRECT not supported)");
+    printf("io_uring %s\n\n", haveUring ? "available" : "not available, using the thread pool");
+    printf("%6s %12s %12s %12s\n", "depth", "POSIX AIO", "threads", "io_uring");
+    printf("%6s %12s %12s %12s\n", "", "K IOPS", "K IOPS", "K IOPS");
+
+    long errors = 0;
+    unsigned depths[] = {1, 4, 16, 64};
+    for (int i = 0; i < 4; i++) {
+        EngineKind kind;
+        double aio = runAio(fd, blocks, depths[i], reads, &errors);
+        double pool = runEngine(fd, blocks, depths[i], reads, 1, &errors, &kind);
+        printf("%6u %12.1f %12.1f", depths[i], aio, pool);
+        if (haveUring) {
+            printf(" %12.1f", runEngine(fd, blocks, depths[i], reads, 0, &errors, &kind));
+        }
+        printf("\n");
+    }
+    printf("\nBlocks with wrong contents: %ld\n", errors);
+
+    close(fd);
+    remove(path);
+    return 0;
+}
\ No newline at end of file